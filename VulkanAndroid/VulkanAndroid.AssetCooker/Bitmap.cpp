@@ -0,0 +1,129 @@
+#include "Bitmap.h"
+#include <algorithm>
+#include <cmath>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+Bitmap::Bitmap(uint32_t width, uint32_t height)
+    : width(width), height(height), pixels(size_t(width) * height * CHANNEL_COUNT)
+{
+}
+
+Bitmap Bitmap::load(const std::string &path)
+{
+    int width, height;
+    stbi_uc *data = stbi_load(path.c_str(), &width, &height, nullptr, STBI_rgb_alpha);
+
+    if (!data)
+    {
+        return Bitmap();
+    }
+
+    Bitmap bitmap{ uint32_t(width), uint32_t(height) };
+    std::copy(data, data + bitmap.pixels.size(), bitmap.pixels.begin());
+
+    stbi_image_free(data);
+
+    return bitmap;
+}
+
+bool Bitmap::empty() const
+{
+    return pixels.empty();
+}
+
+uint32_t Bitmap::getWidth() const
+{
+    return width;
+}
+
+uint32_t Bitmap::getHeight() const
+{
+    return height;
+}
+
+const std::vector<uint8_t>& Bitmap::getPixels() const
+{
+    return pixels;
+}
+
+std::vector<uint8_t> Bitmap::getPixels(uint32_t channelCount) const
+{
+    if (channelCount >= CHANNEL_COUNT)
+    {
+        return pixels;
+    }
+
+    std::vector<uint8_t> result;
+    result.reserve(size_t(width) * height * channelCount);
+    for (size_t i = 0; i < pixels.size(); i += CHANNEL_COUNT)
+    {
+        result.insert(result.end(), pixels.begin() + i, pixels.begin() + i + channelCount);
+    }
+
+    return result;
+}
+
+const uint8_t* Bitmap::getPixel(int32_t x, int32_t y) const
+{
+    x = (std::min)((std::max)(x, 0), int32_t(width) - 1);
+    y = (std::min)((std::max)(y, 0), int32_t(height) - 1);
+
+    return pixels.data() + (size_t(y) * width + x) * CHANNEL_COUNT;
+}
+
+uint8_t* Bitmap::getPixel(int32_t x, int32_t y)
+{
+    return const_cast<uint8_t*>(static_cast<const Bitmap*>(this)->getPixel(x, y));
+}
+
+bool Bitmap::isOpaque() const
+{
+    for (size_t i = CHANNEL_COUNT - 1; i < pixels.size(); i += CHANNEL_COUNT)
+    {
+        if (pixels[i] != 255)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Bitmap Bitmap::downsample() const
+{
+    Bitmap result((std::max)(width >> 1, 1u), (std::max)(height >> 1, 1u));
+
+    // one source texel in dimension of size 1
+    const int32_t stepX = width > 1 ? 1 : 0;
+    const int32_t stepY = height > 1 ? 1 : 0;
+
+    for (uint32_t y = 0; y < result.height; y++)
+    {
+        for (uint32_t x = 0; x < result.width; x++)
+        {
+            const int32_t srcX = int32_t(x) * 2;
+            const int32_t srcY = int32_t(y) * 2;
+
+            const uint8_t *texels[4]{
+                getPixel(srcX, srcY),
+                getPixel(srcX + stepX, srcY),
+                getPixel(srcX, srcY + stepY),
+                getPixel(srcX + stepX, srcY + stepY)
+            };
+
+            uint8_t *pixel = result.getPixel(int32_t(x), int32_t(y));
+            for (uint32_t i = 0; i < CHANNEL_COUNT; i++)
+            {
+                pixel[i] = uint8_t((texels[0][i] + texels[1][i] + texels[2][i] + texels[3][i] + 2) / 4);
+            }
+        }
+    }
+
+    return result;
+}
+
+uint32_t Bitmap::getMipLevelCount() const
+{
+    return uint32_t(std::floor(std::log2((std::max)(width, height)))) + 1;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// RGBA8 image in host memory
+class Bitmap
+{
+public:
+    static const uint32_t CHANNEL_COUNT = 4;
+
+    Bitmap() = default;
+
+    Bitmap(uint32_t width, uint32_t height);
+
+    // decodes jpg or png file, returns empty bitmap on failure
+    static Bitmap load(const std::string &path);
+
+    bool empty() const;
+
+    uint32_t getWidth() const;
+
+    uint32_t getHeight() const;
+
+    const std::vector<uint8_t>& getPixels() const;
+
+    // pixels with only the first channelCount channels
+    std::vector<uint8_t> getPixels(uint32_t channelCount) const;
+
+    // coordinates are clamped to edges
+    const uint8_t* getPixel(int32_t x, int32_t y) const;
+
+    uint8_t* getPixel(int32_t x, int32_t y);
+
+    // all pixels have maximal alpha, so alpha channel can be trimmed
+    bool isOpaque() const;
+
+    // next mip level (box filter, odd sizes are rounded down)
+    Bitmap downsample() const;
+
+    // number of levels of full mip chain (down to 1x1)
+    uint32_t getMipLevelCount() const;
+
+private:
+    uint32_t width = 0;
+
+    uint32_t height = 0;
+
+    std::vector<uint8_t> pixels;
+};
@@ -0,0 +1,152 @@
+#include "EacEncoder.h"
+#include <algorithm>
+
+namespace
+{
+    // pixel index of EAC block is x * 4 + y
+    uint32_t pixelIndex(uint32_t x, uint32_t y)
+    {
+        return x * EacEncoder::BLOCK_SIZE + y;
+    }
+
+    // 11-bit value of decoder (EAC specification)
+    int32_t decodeValue(int32_t base, int32_t multiplier, int32_t modifier)
+    {
+        const int32_t value = multiplier > 0
+            ? base * 8 + 4 + modifier * multiplier * 8
+            : base * 8 + 4 + modifier;
+
+        return (std::min)((std::max)(value, 0), 2047);
+    }
+}
+
+// the same tables as for alpha of ETC2 RGBA8
+const int32_t EacEncoder::MODIFIER_TABLES[16][8]{
+    { -3, -6, -9, -15, 2, 5, 8, 14 },
+    { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5, -8, -13, 1, 4, 7, 12 },
+    { -2, -4, -6, -13, 1, 3, 5, 12 },
+    { -3, -6, -8, -12, 2, 5, 7, 11 },
+    { -3, -7, -9, -11, 2, 6, 8, 10 },
+    { -4, -7, -8, -11, 3, 6, 7, 10 },
+    { -3, -5, -8, -11, 2, 4, 7, 10 },
+    { -2, -6, -8, -10, 1, 5, 7, 9 },
+    { -2, -5, -8, -10, 1, 4, 7, 9 },
+    { -2, -4, -8, -10, 1, 3, 7, 9 },
+    { -2, -5, -7, -10, 1, 4, 6, 9 },
+    { -3, -4, -7, -10, 2, 3, 6, 9 },
+    { -1, -2, -3, -10, 0, 1, 2, 9 },
+    { -4, -6, -8, -9, 3, 5, 7, 8 },
+    { -3, -5, -7, -9, 2, 4, 6, 8 }
+};
+
+std::vector<uint8_t> EacEncoder::encode(const Bitmap &bitmap, uint32_t channelCount)
+{
+    const uint32_t blockCountX = (bitmap.getWidth() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const uint32_t blockCountY = (bitmap.getHeight() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const uint32_t blockBytes = CHANNEL_BLOCK_BYTES * channelCount;
+
+    std::vector<uint8_t> blocks(size_t(blockCountX) * blockCountY * blockBytes);
+
+    for (uint32_t y = 0; y < blockCountY; y++)
+    {
+        for (uint32_t x = 0; x < blockCountX; x++)
+        {
+            uint8_t *block = blocks.data() + (size_t(y) * blockCountX + x) * blockBytes;
+
+            for (uint32_t channel = 0; channel < channelCount; channel++)
+            {
+                const uint64_t bits = encodeBlock(bitmap, int32_t(x * BLOCK_SIZE), int32_t(y * BLOCK_SIZE), channel);
+
+                // blocks are stored as big-endian 64-bit words
+                for (uint32_t i = 0; i < CHANNEL_BLOCK_BYTES; i++)
+                {
+                    block[channel * CHANNEL_BLOCK_BYTES + i] = uint8_t(bits >> (56 - 8 * i));
+                }
+            }
+        }
+    }
+
+    return blocks;
+}
+
+uint64_t EacEncoder::encodeBlock(const Bitmap &bitmap, int32_t blockX, int32_t blockY, uint32_t channel)
+{
+    // 8-bit values are expanded to 11 bits of decoder
+    int32_t values[16];
+    int32_t minValue = 2047;
+    int32_t maxValue = 0;
+    for (uint32_t x = 0; x < BLOCK_SIZE; x++)
+    {
+        for (uint32_t y = 0; y < BLOCK_SIZE; y++)
+        {
+            const uint8_t value = bitmap.getPixel(blockX + int32_t(x), blockY + int32_t(y))[channel];
+            const int32_t expanded = (int32_t(value) << 3) | (value >> 5);
+
+            values[pixelIndex(x, y)] = expanded;
+            minValue = (std::min)(minValue, expanded);
+            maxValue = (std::max)(maxValue, expanded);
+        }
+    }
+
+    // base codeword is the center of range, multiplier scales table to range,
+    // neighbouring multipliers are tried because tables aren't symmetric
+    const int32_t base = (std::min)((std::max)(((minValue + maxValue) / 2 - 4) / 8, 0), 255);
+
+    uint32_t bestError = UINT32_MAX;
+    uint64_t bestBits = 0;
+    for (uint32_t table = 0; table < 16; table++)
+    {
+        const int32_t tableRange = MODIFIER_TABLES[table][7] - MODIFIER_TABLES[table][3];
+        const int32_t multiplier = (maxValue - minValue + 4 * tableRange) / (8 * tableRange);
+
+        for (int32_t m = (std::max)(multiplier - 1, 0); m <= (std::min)(multiplier + 1, 15); m++)
+        {
+            uint32_t pixelIndices[16];
+            const uint32_t error = encodeBlock(values, base, m, table, pixelIndices);
+            if (error >= bestError)
+            {
+                continue;
+            }
+
+            bestError = error;
+            bestBits = uint64_t(base) << 56 | uint64_t(m) << 52 | uint64_t(table) << 48;
+
+            // 3-bit pixel indices from the first pixel in the most significant bits
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                bestBits |= uint64_t(pixelIndices[i]) << (45 - 3 * i);
+            }
+        }
+    }
+
+    return bestBits;
+}
+
+uint32_t EacEncoder::encodeBlock(
+    const int32_t values[16],
+    int32_t base,
+    int32_t multiplier,
+    uint32_t table,
+    uint32_t outPixelIndices[16])
+{
+    uint32_t error = 0;
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        uint32_t bestPixelError = UINT32_MAX;
+        for (uint32_t m = 0; m < 8; m++)
+        {
+            const int32_t difference = values[i] - decodeValue(base, multiplier, MODIFIER_TABLES[table][m]);
+            const uint32_t pixelError = uint32_t(difference * difference);
+            if (pixelError < bestPixelError)
+            {
+                bestPixelError = pixelError;
+                outPixelIndices[i] = m;
+            }
+        }
+
+        error += bestPixelError;
+    }
+
+    return error;
+}
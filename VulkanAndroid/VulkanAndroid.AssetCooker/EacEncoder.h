@@ -0,0 +1,31 @@
+#pragma once
+#include "Bitmap.h"
+
+// encodes the first one or two channels of bitmaps into EAC blocks:
+// R11 (VK_FORMAT_EAC_R11_UNORM_BLOCK) or RG11 (VK_FORMAT_EAC_R11G11_UNORM_BLOCK),
+// each channel is stored in its own 64-bit block
+class EacEncoder
+{
+public:
+    static const uint32_t BLOCK_SIZE = 4;
+
+    // bytes of one channel of block
+    static const uint32_t CHANNEL_BLOCK_BYTES = 8;
+
+    // blocks in row-major order, partial blocks at edges are filled by clamping,
+    // channelCount - 1 (R11) or 2 (RG11, red block precedes green one)
+    static std::vector<uint8_t> encode(const Bitmap &bitmap, uint32_t channelCount);
+
+private:
+    static const int32_t MODIFIER_TABLES[16][8];
+
+    static uint64_t encodeBlock(const Bitmap &bitmap, int32_t blockX, int32_t blockY, uint32_t channel);
+
+    // returns error of block with given base codeword, multiplier and table
+    static uint32_t encodeBlock(
+        const int32_t values[16],
+        int32_t base,
+        int32_t multiplier,
+        uint32_t table,
+        uint32_t outPixelIndices[16]);
+};
@@ -0,0 +1,243 @@
+#include "Etc2Encoder.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // pixel index of ETC block is x * 4 + y
+    uint32_t pixelIndex(uint32_t x, uint32_t y)
+    {
+        return x * Etc2Encoder::BLOCK_SIZE + y;
+    }
+
+    int32_t clampColor(int32_t value)
+    {
+        return (std::min)((std::max)(value, 0), 255);
+    }
+
+    // sum of squared differences weighted by perceptual contribution of channels
+    uint32_t colorError(const uint8_t a[3], const int32_t b[3])
+    {
+        const int32_t dr = int32_t(a[0]) - b[0];
+        const int32_t dg = int32_t(a[1]) - b[1];
+        const int32_t db = int32_t(a[2]) - b[2];
+
+        return uint32_t(3 * dr * dr + 6 * dg * dg + db * db);
+    }
+}
+
+const int32_t Etc2Encoder::MODIFIER_TABLES[8][2]{
+    { 2, 8 },
+    { 5, 17 },
+    { 9, 29 },
+    { 13, 42 },
+    { 18, 60 },
+    { 24, 80 },
+    { 33, 106 },
+    { 47, 183 }
+};
+
+std::vector<uint8_t> Etc2Encoder::encode(const Bitmap &bitmap)
+{
+    const uint32_t blockCountX = (bitmap.getWidth() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const uint32_t blockCountY = (bitmap.getHeight() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    std::vector<uint8_t> blocks(size_t(blockCountX) * blockCountY * BLOCK_BYTES);
+
+    for (uint32_t y = 0; y < blockCountY; y++)
+    {
+        for (uint32_t x = 0; x < blockCountX; x++)
+        {
+            const uint64_t bits = encodeBlock(bitmap, int32_t(x * BLOCK_SIZE), int32_t(y * BLOCK_SIZE));
+
+            // blocks are stored as big-endian 64-bit words
+            uint8_t *block = blocks.data() + (size_t(y) * blockCountX + x) * BLOCK_BYTES;
+            for (uint32_t i = 0; i < BLOCK_BYTES; i++)
+            {
+                block[i] = uint8_t(bits >> (56 - 8 * i));
+            }
+        }
+    }
+
+    return blocks;
+}
+
+uint64_t Etc2Encoder::encodeBlock(const Bitmap &bitmap, int32_t blockX, int32_t blockY)
+{
+    uint8_t pixels[16][3];
+    for (uint32_t x = 0; x < BLOCK_SIZE; x++)
+    {
+        for (uint32_t y = 0; y < BLOCK_SIZE; y++)
+        {
+            const uint8_t *pixel = bitmap.getPixel(blockX + int32_t(x), blockY + int32_t(y));
+            std::copy(pixel, pixel + 3, pixels[pixelIndex(x, y)]);
+        }
+    }
+
+    BlockCandidate best{ 0, UINT32_MAX };
+    for (const bool flip : { false, true })
+    {
+        for (const bool differential : { true, false })
+        {
+            const BlockCandidate candidate = encodeBlock(pixels, flip, differential);
+            if (candidate.error < best.error)
+            {
+                best = candidate;
+            }
+        }
+    }
+
+    return best.bits;
+}
+
+Etc2Encoder::BlockCandidate Etc2Encoder::encodeBlock(const uint8_t pixels[16][3], bool flip, bool differential)
+{
+    // without flip sub-blocks are 2x4 (left, right), with flip 4x2 (top, bottom)
+    uint32_t subBlockIndices[2][8];
+    for (uint32_t x = 0; x < BLOCK_SIZE; x++)
+    {
+        for (uint32_t y = 0; y < BLOCK_SIZE; y++)
+        {
+            const uint32_t subBlock = flip ? y / 2 : x / 2;
+            const uint32_t position = flip ? (y % 2) * BLOCK_SIZE + x : (x % 2) * BLOCK_SIZE + y;
+            subBlockIndices[subBlock][position] = pixelIndex(x, y);
+        }
+    }
+
+    // base colors are quantized averages of sub-blocks
+    int32_t quantized[2][3];
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        for (uint32_t channel = 0; channel < 3; channel++)
+        {
+            uint32_t sum = 0;
+            for (uint32_t j = 0; j < 8; j++)
+            {
+                sum += pixels[subBlockIndices[i][j]][channel];
+            }
+
+            const float average = float(sum) / 8.0f;
+            quantized[i][channel] = int32_t(std::lround(average * (differential ? 31.0f : 15.0f) / 255.0f));
+        }
+    }
+
+    int32_t baseColors[2][3];
+    for (uint32_t channel = 0; channel < 3; channel++)
+    {
+        if (differential)
+        {
+            // second color is stored as 3-bit signed delta from the first one
+            const int32_t delta = quantized[1][channel] - quantized[0][channel];
+            quantized[1][channel] = quantized[0][channel] + (std::min)((std::max)(delta, -4), 3);
+
+            for (uint32_t i = 0; i < 2; i++)
+            {
+                baseColors[i][channel] = (quantized[i][channel] << 3) | (quantized[i][channel] >> 2);
+            }
+        }
+        else
+        {
+            for (uint32_t i = 0; i < 2; i++)
+            {
+                baseColors[i][channel] = quantized[i][channel] * 17;
+            }
+        }
+    }
+
+    uint32_t tables[2];
+    uint32_t subBlockPixelIndices[2][8];
+    uint32_t error = 0;
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        error += encodeSubBlock(pixels, subBlockIndices[i], baseColors[i], &tables[i], subBlockPixelIndices[i]);
+    }
+
+    uint64_t bits = 0;
+    for (uint32_t channel = 0; channel < 3; channel++)
+    {
+        const uint32_t shift = 56 - 8 * channel;
+        if (differential)
+        {
+            const int32_t delta = quantized[1][channel] - quantized[0][channel];
+            bits |= uint64_t(quantized[0][channel]) << (shift + 3);
+            bits |= uint64_t(delta & 0x7) << shift;
+        }
+        else
+        {
+            bits |= uint64_t(quantized[0][channel]) << (shift + 4);
+            bits |= uint64_t(quantized[1][channel]) << shift;
+        }
+    }
+
+    bits |= uint64_t(tables[0]) << 37;
+    bits |= uint64_t(tables[1]) << 34;
+    bits |= uint64_t(differential ? 1 : 0) << 33;
+    bits |= uint64_t(flip ? 1 : 0) << 32;
+
+    // least significant bits of pixel indices in bits 0-15, most significant in bits 16-31
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        for (uint32_t j = 0; j < 8; j++)
+        {
+            const uint32_t index = subBlockPixelIndices[i][j];
+            const uint32_t pixel = subBlockIndices[i][j];
+            bits |= uint64_t(index & 1) << pixel;
+            bits |= uint64_t(index >> 1) << (pixel + 16);
+        }
+    }
+
+    return BlockCandidate{ bits, error };
+}
+
+uint32_t Etc2Encoder::encodeSubBlock(
+    const uint8_t pixels[16][3],
+    const uint32_t indices[8],
+    const int32_t baseColor[3],
+    uint32_t *outTable,
+    uint32_t outPixelIndices[8])
+{
+    // pixel index selects modifier: 0 - +small, 1 - +large, 2 - -small, 3 - -large
+    uint32_t bestError = UINT32_MAX;
+    for (uint32_t table = 0; table < 8; table++)
+    {
+        const int32_t modifiers[4]{
+            MODIFIER_TABLES[table][0],
+            MODIFIER_TABLES[table][1],
+            -MODIFIER_TABLES[table][0],
+            -MODIFIER_TABLES[table][1]
+        };
+
+        uint32_t tableError = 0;
+        uint32_t tablePixelIndices[8];
+        for (uint32_t j = 0; j < 8; j++)
+        {
+            uint32_t bestPixelError = UINT32_MAX;
+            for (uint32_t m = 0; m < 4; m++)
+            {
+                const int32_t color[3]{
+                    clampColor(baseColor[0] + modifiers[m]),
+                    clampColor(baseColor[1] + modifiers[m]),
+                    clampColor(baseColor[2] + modifiers[m])
+                };
+
+                const uint32_t pixelError = colorError(pixels[indices[j]], color);
+                if (pixelError < bestPixelError)
+                {
+                    bestPixelError = pixelError;
+                    tablePixelIndices[j] = m;
+                }
+            }
+
+            tableError += bestPixelError;
+        }
+
+        if (tableError < bestError)
+        {
+            bestError = tableError;
+            *outTable = table;
+            std::copy(tablePixelIndices, tablePixelIndices + 8, outPixelIndices);
+        }
+    }
+
+    return bestError;
+}
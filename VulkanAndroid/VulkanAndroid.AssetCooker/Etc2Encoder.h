@@ -0,0 +1,36 @@
+#pragma once
+#include "Bitmap.h"
+
+// encodes opaque bitmaps into ETC2 RGB8 blocks (VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK);
+// only individual and differential modes are used, they are shared by ETC1 and ETC2
+class Etc2Encoder
+{
+public:
+    static const uint32_t BLOCK_SIZE = 4;
+
+    static const uint32_t BLOCK_BYTES = 8;
+
+    // blocks in row-major order, partial blocks at edges are filled by clamping
+    static std::vector<uint8_t> encode(const Bitmap &bitmap);
+
+private:
+    struct BlockCandidate
+    {
+        uint64_t bits;
+        uint32_t error;
+    };
+
+    static const int32_t MODIFIER_TABLES[8][2];
+
+    static uint64_t encodeBlock(const Bitmap &bitmap, int32_t blockX, int32_t blockY);
+
+    static BlockCandidate encodeBlock(const uint8_t pixels[16][3], bool flip, bool differential);
+
+    // chooses table and pixel indices of sub-block for base color, returns error of sub-block
+    static uint32_t encodeSubBlock(
+        const uint8_t pixels[16][3],
+        const uint32_t indices[8],
+        const int32_t baseColor[3],
+        uint32_t *outTable,
+        uint32_t outPixelIndices[8]);
+};
@@ -0,0 +1,231 @@
+#include "Ktx2Writer.h"
+#include <cstdio>
+#include <numeric>
+
+namespace
+{
+    const uint8_t IDENTIFIER[12]{
+        0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+    };
+
+    // header, index and level index entries (KTX 2.0 specification)
+    const size_t HEADER_SIZE = 80;
+    const size_t LEVEL_INDEX_ENTRY_SIZE = 3 * sizeof(uint64_t);
+
+    // values of Khronos Data Format Specification
+    const uint32_t KHR_DF_MODEL_RGBSDA = 1;
+    const uint32_t KHR_DF_MODEL_ETC2 = 161;
+    const uint32_t KHR_DF_PRIMARIES_BT709 = 1;
+    const uint32_t KHR_DF_TRANSFER_LINEAR = 1;
+    const uint32_t KHR_DF_CHANNEL_RGBSDA_RED = 0;
+    const uint32_t KHR_DF_CHANNEL_RGBSDA_GREEN = 1;
+    const uint32_t KHR_DF_CHANNEL_RGBSDA_BLUE = 2;
+    const uint32_t KHR_DF_CHANNEL_RGBSDA_ALPHA = 15;
+    const uint32_t KHR_DF_CHANNEL_ETC2_RED = 0;
+    const uint32_t KHR_DF_CHANNEL_ETC2_GREEN = 1;
+    const uint32_t KHR_DF_CHANNEL_ETC2_COLOR = 2;
+    const uint32_t KHR_DF_VERSION = 2;
+    const uint32_t DESCRIPTOR_BLOCK_HEADER_SIZE = 24;
+    const uint32_t SAMPLE_SIZE = 16;
+
+    template<class T>
+    void append(std::vector<uint8_t> &buffer, T value)
+    {
+        // KTX 2.0 is little-endian as well as all supported hosts
+        const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    void alignBuffer(std::vector<uint8_t> &buffer, size_t alignment)
+    {
+        buffer.resize((buffer.size() + alignment - 1) / alignment * alignment, 0);
+    }
+}
+
+Ktx2Writer::Ktx2Writer(Format format, uint32_t width, uint32_t height, uint32_t faceCount)
+    : format(format), width(width), height(height), faceCount(faceCount)
+{
+}
+
+void Ktx2Writer::addLevel(std::vector<uint8_t> data)
+{
+    levels.push_back(std::move(data));
+}
+
+bool Ktx2Writer::write(const std::string &path) const
+{
+    const std::vector<uint8_t> dfd = createDataFormatDescriptor();
+
+    const size_t dfdOffset = HEADER_SIZE + levels.size() * LEVEL_INDEX_ENTRY_SIZE;
+
+    std::vector<uint8_t> file;
+    file.insert(file.end(), IDENTIFIER, IDENTIFIER + sizeof(IDENTIFIER));
+    append<uint32_t>(file, format);
+    append<uint32_t>(file, 1);
+    append<uint32_t>(file, width);
+    append<uint32_t>(file, height);
+    append<uint32_t>(file, 0);
+    append<uint32_t>(file, 0);
+    append<uint32_t>(file, faceCount);
+    append<uint32_t>(file, uint32_t(levels.size()));
+    append<uint32_t>(file, 0);
+    append<uint32_t>(file, uint32_t(dfdOffset));
+    append<uint32_t>(file, uint32_t(dfd.size()));
+    append<uint32_t>(file, 0);
+    append<uint32_t>(file, 0);
+    append<uint64_t>(file, 0);
+    append<uint64_t>(file, 0);
+
+    // level index is filled after placement of levels
+    const size_t levelIndexOffset = file.size();
+    file.resize(dfdOffset, 0);
+    file.insert(file.end(), dfd.begin(), dfd.end());
+
+    // levels are stored from the smallest one, each aligned to lcm(texel block size, 4)
+    const size_t alignment = std::lcm(size_t(getBlockBytes()), size_t(4));
+    std::vector<uint64_t> levelOffsets(levels.size());
+    for (size_t i = levels.size(); i-- > 0;)
+    {
+        alignBuffer(file, alignment);
+        levelOffsets[i] = file.size();
+        file.insert(file.end(), levels[i].begin(), levels[i].end());
+    }
+
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+        uint8_t *entry = file.data() + levelIndexOffset + i * LEVEL_INDEX_ENTRY_SIZE;
+        const uint64_t values[3]{ levelOffsets[i], levels[i].size(), levels[i].size() };
+        std::copy(
+            reinterpret_cast<const uint8_t*>(values),
+            reinterpret_cast<const uint8_t*>(values) + LEVEL_INDEX_ENTRY_SIZE,
+            entry);
+    }
+
+    const std::string temporaryPath = path + ".tmp";
+    FILE *output = fopen(temporaryPath.c_str(), "wb");
+    if (!output)
+    {
+        return false;
+    }
+
+    const bool written = fwrite(file.data(), 1, file.size(), output) == file.size();
+    if (fclose(output) != 0 || !written)
+    {
+        remove(temporaryPath.c_str());
+        return false;
+    }
+
+    return rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+std::vector<uint8_t> Ktx2Writer::createDataFormatDescriptor() const
+{
+    struct Sample
+    {
+        uint32_t bitOffset;
+        uint32_t bitLength;
+        uint32_t channel;
+        uint32_t upper;
+    };
+
+    const bool compressed = format == FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+        || format == FORMAT_EAC_R11_UNORM_BLOCK
+        || format == FORMAT_EAC_R11G11_UNORM_BLOCK;
+
+    const uint32_t colorModel = compressed ? KHR_DF_MODEL_ETC2 : KHR_DF_MODEL_RGBSDA;
+
+    // dimensions of texel block minus one
+    const uint8_t blockDimension = compressed ? 3 : 0;
+
+    std::vector<Sample> samples;
+    switch (format)
+    {
+    case FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+        samples = {
+            { 0, 64, KHR_DF_CHANNEL_ETC2_COLOR, UINT32_MAX }
+        };
+        break;
+    case FORMAT_EAC_R11_UNORM_BLOCK:
+    case FORMAT_EAC_R11G11_UNORM_BLOCK:
+        // EAC stores each channel in its own 64-bit block
+        samples = {
+            { 0, 64, KHR_DF_CHANNEL_ETC2_RED, UINT32_MAX },
+            { 64, 64, KHR_DF_CHANNEL_ETC2_GREEN, UINT32_MAX }
+        };
+        samples.resize(getChannelCount());
+        break;
+    default:
+        samples = {
+            { 0, 8, KHR_DF_CHANNEL_RGBSDA_RED, 255 },
+            { 8, 8, KHR_DF_CHANNEL_RGBSDA_GREEN, 255 },
+            { 16, 8, KHR_DF_CHANNEL_RGBSDA_BLUE, 255 },
+            { 24, 8, KHR_DF_CHANNEL_RGBSDA_ALPHA, 255 }
+        };
+        samples.resize(getChannelCount());
+        break;
+    }
+
+    const uint32_t blockSize = DESCRIPTOR_BLOCK_HEADER_SIZE + SAMPLE_SIZE * uint32_t(samples.size());
+
+    std::vector<uint8_t> dfd;
+    append<uint32_t>(dfd, sizeof(uint32_t) + blockSize);
+
+    // vendor id and descriptor type are zero (Khronos basic descriptor)
+    append<uint32_t>(dfd, 0);
+    append<uint16_t>(dfd, uint16_t(KHR_DF_VERSION));
+    append<uint16_t>(dfd, uint16_t(blockSize));
+    append<uint8_t>(dfd, uint8_t(colorModel));
+    append<uint8_t>(dfd, uint8_t(KHR_DF_PRIMARIES_BT709));
+    append<uint8_t>(dfd, uint8_t(KHR_DF_TRANSFER_LINEAR));
+    append<uint8_t>(dfd, 0);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        append<uint8_t>(dfd, i < 2 ? blockDimension : 0);
+    }
+    append<uint8_t>(dfd, uint8_t(getBlockBytes()));
+    for (uint32_t i = 1; i < 8; i++)
+    {
+        append<uint8_t>(dfd, 0);
+    }
+
+    for (const auto &sample : samples)
+    {
+        append<uint16_t>(dfd, uint16_t(sample.bitOffset));
+        append<uint8_t>(dfd, uint8_t(sample.bitLength - 1));
+        append<uint8_t>(dfd, uint8_t(sample.channel));
+        append<uint32_t>(dfd, 0);
+        append<uint32_t>(dfd, 0);
+        append<uint32_t>(dfd, sample.upper);
+    }
+
+    return dfd;
+}
+
+uint32_t Ktx2Writer::getBlockBytes() const
+{
+    switch (format)
+    {
+    case FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+    case FORMAT_EAC_R11_UNORM_BLOCK:
+        return 8;
+    case FORMAT_EAC_R11G11_UNORM_BLOCK:
+        return 16;
+    default:
+        return getChannelCount();
+    }
+}
+
+uint32_t Ktx2Writer::getChannelCount() const
+{
+    switch (format)
+    {
+    case FORMAT_R8_UNORM:
+    case FORMAT_EAC_R11_UNORM_BLOCK:
+        return 1;
+    case FORMAT_R8G8_UNORM:
+    case FORMAT_EAC_R11G11_UNORM_BLOCK:
+        return 2;
+    default:
+        return 4;
+    }
+}
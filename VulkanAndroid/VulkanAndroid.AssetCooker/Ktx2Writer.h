@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// writes KTX 2.0 files without supercompression in layout read by Ktx2File of the application
+class Ktx2Writer
+{
+public:
+    // values of VkFormat (Vulkan headers aren't required on host)
+    enum Format : uint32_t
+    {
+        FORMAT_R8_UNORM = 9,
+        FORMAT_R8G8_UNORM = 16,
+        FORMAT_R8G8B8A8_UNORM = 37,
+        FORMAT_ETC2_R8G8B8_UNORM_BLOCK = 147,
+        FORMAT_EAC_R11_UNORM_BLOCK = 153,
+        FORMAT_EAC_R11G11_UNORM_BLOCK = 155
+    };
+
+    Ktx2Writer(Format format, uint32_t width, uint32_t height, uint32_t faceCount);
+
+    // levels are added from the largest one, data contains all faces one after another
+    void addLevel(std::vector<uint8_t> data);
+
+    // writes to temporary file which replaces destination, so readers never see partial file
+    bool write(const std::string &path) const;
+
+private:
+    Format format;
+
+    uint32_t width;
+
+    uint32_t height;
+
+    uint32_t faceCount;
+
+    std::vector<std::vector<uint8_t>> levels;
+
+    // data format descriptor (Khronos Data Format Specification) of format
+    std::vector<uint8_t> createDataFormatDescriptor() const;
+
+    // texel block size in bytes
+    uint32_t getBlockBytes() const;
+
+    // number of channels stored by format (all four for ETC2 RGB8)
+    uint32_t getChannelCount() const;
+};
@@ -0,0 +1,353 @@
+#include "TextureCooker.h"
+#include "EacEncoder.h"
+#include "Etc2Encoder.h"
+#include "Ktx2Writer.h"
+#include "TiledTextureWriter.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+TextureCooker::TextureCooker(const fs::path &texturesPath, const fs::path &manifestPath)
+    : texturesPath(texturesPath), manifestPath(manifestPath)
+{
+}
+
+uint32_t TextureCooker::cook(uint32_t threadCount, bool force)
+{
+    loadManifest();
+
+    const std::vector<Job> jobs = findJobs();
+
+    // manifest is only read and written by this thread,
+    // workers get jobs which aren't up to date and report results to their own slots
+    std::vector<std::string> signatures;
+    std::vector<uint32_t> pendingJobs;
+    for (uint32_t i = 0; i < jobs.size(); i++)
+    {
+        signatures.push_back(createSignature(jobs[i]));
+
+        if (force || !upToDate(jobs[i], signatures[i]))
+        {
+            pendingJobs.push_back(i);
+        }
+    }
+
+    std::vector<Result> results(jobs.size(), Result::UP_TO_DATE);
+
+    std::atomic<uint32_t> nextJob{ 0 };
+
+    // each thread takes the next job until all of them are done
+    const auto worker = [&]()
+    {
+        for (uint32_t i = nextJob++; i < pendingJobs.size(); i = nextJob++)
+        {
+            const uint32_t jobIndex = pendingJobs[i];
+            const Job &job = jobs[jobIndex];
+
+            const auto start = std::chrono::steady_clock::now();
+            if (cookJob(job))
+            {
+                const std::chrono::duration<float> duration = std::chrono::steady_clock::now() - start;
+                log("Cooked: " + job.output.string() + " (" + std::to_string(duration.count()) + " s)");
+                results[jobIndex] = Result::COOKED;
+            }
+            else
+            {
+                log("Failed: " + job.output.string());
+                results[jobIndex] = Result::FAILED;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < (std::max)(threadCount, 1u); i++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    uint32_t cookedCount = 0;
+    uint32_t failedCount = 0;
+    for (uint32_t i = 0; i < jobs.size(); i++)
+    {
+        if (results[i] == Result::COOKED)
+        {
+            manifest[getManifestKey(jobs[i])] = signatures[i];
+            cookedCount++;
+        }
+        if (results[i] == Result::FAILED)
+        {
+            failedCount++;
+        }
+    }
+
+    saveManifest();
+
+    log("Textures: " + std::to_string(jobs.size())
+        + ", cooked: " + std::to_string(cookedCount)
+        + ", up to date: " + std::to_string(jobs.size() - cookedCount - failedCount)
+        + ", failed: " + std::to_string(failedCount));
+
+    return failedCount;
+}
+
+std::vector<TextureCooker::Job> TextureCooker::findJobs() const
+{
+    std::vector<Job> jobs;
+
+    std::vector<fs::path> directories{ texturesPath };
+    for (const auto &entry : fs::recursive_directory_iterator(texturesPath))
+    {
+        if (entry.is_directory())
+        {
+            directories.push_back(entry.path());
+        }
+    }
+
+    for (const auto &directory : directories)
+    {
+        // directory with all faces of cube map contains sky box
+        const bool cubeMap = std::all_of(CUBE_MAP_FILES.begin(), CUBE_MAP_FILES.end(), [&](const std::string &face)
+        {
+            return fs::is_regular_file(directory / face);
+        });
+
+        const bool virtualTexture = directory.filename() == VIRTUAL_DIRECTORY;
+
+        if (cubeMap && !virtualTexture)
+        {
+            Job job{ {}, directory / CUBE_MAP_NAME, false, Bitmap::CHANNEL_COUNT };
+            for (const auto &face : CUBE_MAP_FILES)
+            {
+                job.inputs.push_back(directory / face);
+            }
+            jobs.push_back(job);
+        }
+
+        for (const auto &entry : fs::directory_iterator(directory))
+        {
+            std::string extension = entry.path().extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+            const bool image = entry.is_regular_file()
+                && std::find(INPUT_EXTENSIONS.begin(), INPUT_EXTENSIONS.end(), extension) != INPUT_EXTENSIONS.end();
+            const bool face = cubeMap && !virtualTexture
+                && std::find(CUBE_MAP_FILES.begin(), CUBE_MAP_FILES.end(), entry.path().filename().string()) != CUBE_MAP_FILES.end();
+
+            if (image && !face)
+            {
+                const fs::path output = fs::path(entry.path()).replace_extension();
+                jobs.push_back(Job{ { entry.path() }, output, virtualTexture, getChannelCount(output) });
+            }
+        }
+    }
+
+    // the largest textures are started first, so threads finish at the same time
+    std::sort(jobs.begin(), jobs.end(), [](const Job &a, const Job &b)
+    {
+        const auto size = [](const Job &job)
+        {
+            uintmax_t result = 0;
+            for (const auto &input : job.inputs)
+            {
+                result += fs::file_size(input);
+            }
+            return result;
+        };
+        return size(a) > size(b);
+    });
+
+    return jobs;
+}
+
+uint32_t TextureCooker::getChannelCount(const fs::path &output) const
+{
+    const auto it = CHANNEL_COUNTS.find(output.filename().string());
+
+    return it != CHANNEL_COUNTS.end() ? it->second : Bitmap::CHANNEL_COUNT;
+}
+
+std::string TextureCooker::getManifestKey(const Job &job) const
+{
+    return fs::relative(job.output, texturesPath).generic_string();
+}
+
+std::string TextureCooker::createSignature(const Job &job) const
+{
+    std::ostringstream signature;
+    signature << VERSION;
+
+    for (const auto &input : job.inputs)
+    {
+        const auto time = fs::last_write_time(input).time_since_epoch().count();
+        signature << '|' << input.filename().string() << ':' << fs::file_size(input) << ':' << time;
+    }
+
+    return signature.str();
+}
+
+bool TextureCooker::upToDate(const Job &job, const std::string &signature) const
+{
+    const auto it = manifest.find(getManifestKey(job));
+    if (it == manifest.end() || it->second != signature)
+    {
+        return false;
+    }
+
+    // outputs could be deleted after cooking
+    return fs::exists(fs::path(job.output).concat(job.virtualTexture ? ".vtex" : ".ktx2"));
+}
+
+bool TextureCooker::cookJob(const Job &job) const
+{
+    if (job.virtualTexture)
+    {
+        return cookVirtualTexture(job);
+    }
+
+    std::vector<Bitmap> faces;
+    for (const auto &input : job.inputs)
+    {
+        Bitmap bitmap = Bitmap::load(input.string());
+        if (bitmap.empty())
+        {
+            return false;
+        }
+
+        const bool sameExtent = faces.empty()
+            || (bitmap.getWidth() == faces[0].getWidth() && bitmap.getHeight() == faces[0].getHeight());
+        if (!sameExtent)
+        {
+            return false;
+        }
+
+        faces.push_back(std::move(bitmap));
+    }
+
+    const uint32_t width = faces[0].getWidth();
+    const uint32_t height = faces[0].getHeight();
+    const uint32_t faceCount = uint32_t(faces.size());
+
+    // textures with less channels are compressed by EAC with the same channels,
+    // alpha isn't stored in ETC2 RGB8, so other textures are compressed only if they are opaque
+    const bool eac = job.channelCount < Bitmap::CHANNEL_COUNT;
+    const bool compressible = eac || std::all_of(faces.begin(), faces.end(), [](const Bitmap &face)
+    {
+        return face.isOpaque();
+    });
+
+    const Ktx2Writer::Format uncompressedFormat = job.channelCount == 1
+        ? Ktx2Writer::FORMAT_R8_UNORM
+        : job.channelCount == 2 ? Ktx2Writer::FORMAT_R8G8_UNORM : Ktx2Writer::FORMAT_R8G8B8A8_UNORM;
+    const Ktx2Writer::Format compressedFormat = job.channelCount == 1
+        ? Ktx2Writer::FORMAT_EAC_R11_UNORM_BLOCK
+        : job.channelCount == 2 ? Ktx2Writer::FORMAT_EAC_R11G11_UNORM_BLOCK : Ktx2Writer::FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+
+    Ktx2Writer uncompressed(uncompressedFormat, width, height, faceCount);
+    Ktx2Writer compressed(compressedFormat, width, height, faceCount);
+
+    const uint32_t levelCount = faces[0].getMipLevelCount();
+    for (uint32_t level = 0; level < levelCount; level++)
+    {
+        std::vector<uint8_t> uncompressedLevel;
+        std::vector<uint8_t> compressedLevel;
+
+        for (auto &face : faces)
+        {
+            if (level > 0)
+            {
+                face = face.downsample();
+            }
+
+            const std::vector<uint8_t> pixels = face.getPixels(job.channelCount);
+            uncompressedLevel.insert(uncompressedLevel.end(), pixels.begin(), pixels.end());
+
+            if (compressible)
+            {
+                const std::vector<uint8_t> blocks = eac
+                    ? EacEncoder::encode(face, job.channelCount)
+                    : Etc2Encoder::encode(face);
+                compressedLevel.insert(compressedLevel.end(), blocks.begin(), blocks.end());
+            }
+        }
+
+        uncompressed.addLevel(std::move(uncompressedLevel));
+        compressed.addLevel(std::move(compressedLevel));
+    }
+
+    const fs::path compressedPath = fs::path(job.output).concat(".etc2.ktx2");
+    if (compressible)
+    {
+        if (!compressed.write(compressedPath.string()))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        // stale compressed version would be preferred by application
+        fs::remove(compressedPath);
+    }
+
+    return uncompressed.write(fs::path(job.output).concat(".ktx2").string());
+}
+
+bool TextureCooker::cookVirtualTexture(const Job &job) const
+{
+    Bitmap level = Bitmap::load(job.inputs[0].string());
+    if (level.empty())
+    {
+        return false;
+    }
+
+    TiledTextureWriter writer(level.getWidth(), level.getHeight());
+
+    const uint32_t levelCount = level.getMipLevelCount();
+    for (uint32_t i = 0; i < levelCount; i++)
+    {
+        if (i > 0)
+        {
+            level = level.downsample();
+        }
+
+        writer.addLevel(level);
+    }
+
+    return writer.write(fs::path(job.output).concat(".vtex").string());
+}
+
+void TextureCooker::loadManifest()
+{
+    std::ifstream file(manifestPath);
+
+    std::string output;
+    std::string signature;
+    while (std::getline(file, output) && std::getline(file, signature))
+    {
+        manifest[output] = signature;
+    }
+}
+
+void TextureCooker::saveManifest() const
+{
+    std::ofstream file(manifestPath, std::ios::trunc);
+
+    for (const auto &entry : manifest)
+    {
+        file << entry.first << '\n' << entry.second << '\n';
+    }
+}
+
+void TextureCooker::log(const std::string &message)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::cout << message << std::endl;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include "Bitmap.h"
+#include <filesystem>
+#include <map>
+#include <mutex>
+
+namespace fs = std::filesystem;
+
+// cooks jpg and png textures into KTX 2.0 files with pre-generated mip levels:
+// name.ktx2 (RGBA8 or less channels, loaded on any device) and name.etc2.ktx2
+// (EAC R11 or RG11 for textures with less channels, otherwise ETC2 RGB8 of only opaque textures);
+// six faces of sky box in one directory are cooked into one cube map;
+// textures of directories named VIRTUAL_DIRECTORY are cooked only into name.vtex (tiled RGBA8);
+// textures whose inputs aren't changed since the last run are skipped
+class TextureCooker
+{
+public:
+    // manifestPath - file with signatures of cooked inputs (outside of assets, so it isn't packaged)
+    TextureCooker(const fs::path &texturesPath, const fs::path &manifestPath);
+
+    // returns number of failed textures
+    uint32_t cook(uint32_t threadCount, bool force);
+
+private:
+    // increased when output of cooker changes, so all textures are cooked again
+    const std::string VERSION = "4";
+
+    // faces in the same order as Skybox::CUBE_MAP_FILES of the application
+    const std::vector<std::string> CUBE_MAP_FILES{
+        "Back.png",
+        "Down.png",
+        "Front.png",
+        "Left.png",
+        "Right.png",
+        "Top.png"
+    };
+
+    // the same as Skybox::CUBE_MAP_KTX2_FILE without extension
+    const std::string CUBE_MAP_NAME = "Cube";
+
+    const std::vector<std::string> INPUT_EXTENSIONS{ ".jpg", ".jpeg", ".png" };
+
+    // textures whose shaders use less channels (file name without extension -> channel count),
+    // the same as channel counts requested by the application when it decodes them (see Clouds and Earth)
+    const std::map<std::string, uint32_t> CHANNEL_COUNTS{
+        { "Clouds", 1 },
+        { "Normal", 2 }
+    };
+
+    // the same as Earth::VIRTUAL_TEXTURE_PATH of the application
+    const std::string VIRTUAL_DIRECTORY = "virtual";
+
+    struct Job
+    {
+        // one image or faces of cube map
+        std::vector<fs::path> inputs;
+
+        // output path without extension
+        fs::path output;
+
+        // tiled texture for virtual texturing instead of KTX 2.0 files
+        bool virtualTexture;
+
+        // channels of uncompressed version (1, 2 or 4)
+        uint32_t channelCount;
+    };
+
+    // written by the worker which cooks the job
+    enum class Result
+    {
+        UP_TO_DATE,
+        COOKED,
+        FAILED
+    };
+
+    fs::path texturesPath;
+
+    fs::path manifestPath;
+
+    // output path -> signature of inputs
+    std::map<std::string, std::string> manifest;
+
+    // synchronizes log of workers
+    std::mutex mutex;
+
+    std::vector<Job> findJobs() const;
+
+    uint32_t getChannelCount(const fs::path &output) const;
+
+    // output path relative to textures directory, so manifest doesn't depend on working directory
+    std::string getManifestKey(const Job &job) const;
+
+    std::string createSignature(const Job &job) const;
+
+    bool upToDate(const Job &job, const std::string &signature) const;
+
+    bool cookJob(const Job &job) const;
+
+    bool cookVirtualTexture(const Job &job) const;
+
+    void loadManifest();
+
+    void saveManifest() const;
+
+    void log(const std::string &message);
+};
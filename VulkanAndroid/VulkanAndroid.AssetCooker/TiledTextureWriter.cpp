@@ -0,0 +1,102 @@
+#include "TiledTextureWriter.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    // "VTEX", version 1
+    const uint8_t IDENTIFIER[8]{
+        0x56, 0x54, 0x45, 0x58, 0x01, 0x00, 0x00, 0x00
+    };
+
+    // fixed part of header (the same as TiledTextureFile of the application)
+    const size_t HEADER_SIZE = 40;
+    const size_t LEVEL_INDEX_ENTRY_SIZE = sizeof(uint64_t) + 2 * sizeof(uint32_t);
+
+    const uint32_t TILE_SIZE = TiledTextureWriter::TILE_WIDTH * TiledTextureWriter::TILE_HEIGHT * Bitmap::CHANNEL_COUNT;
+
+    template<class T>
+    void append(std::vector<uint8_t> &buffer, T value)
+    {
+        // tiled texture is little-endian as well as all supported hosts
+        const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+}
+
+TiledTextureWriter::TiledTextureWriter(uint32_t width, uint32_t height)
+    : width(width), height(height)
+{
+}
+
+void TiledTextureWriter::addLevel(const Bitmap &level)
+{
+    const uint32_t tileCountX = (level.getWidth() + TILE_WIDTH - 1) / TILE_WIDTH;
+    const uint32_t tileCountY = (level.getHeight() + TILE_HEIGHT - 1) / TILE_HEIGHT;
+
+    std::vector<uint8_t> tiles(size_t(tileCountX) * tileCountY * TILE_SIZE);
+    uint8_t *texel = tiles.data();
+    for (uint32_t tileY = 0; tileY < tileCountY; tileY++)
+    {
+        for (uint32_t tileX = 0; tileX < tileCountX; tileX++)
+        {
+            // texels out of level are clamped to edges
+            for (uint32_t y = 0; y < TILE_HEIGHT; y++)
+            {
+                for (uint32_t x = 0; x < TILE_WIDTH; x++)
+                {
+                    const uint8_t *pixel = level.getPixel(
+                        int32_t(tileX * TILE_WIDTH + x),
+                        int32_t(tileY * TILE_HEIGHT + y));
+                    texel = std::copy(pixel, pixel + Bitmap::CHANNEL_COUNT, texel);
+                }
+            }
+        }
+    }
+
+    levels.push_back(Level{ tileCountX, tileCountY, std::move(tiles) });
+}
+
+bool TiledTextureWriter::write(const std::string &path) const
+{
+    std::vector<uint8_t> header(IDENTIFIER, IDENTIFIER + sizeof(IDENTIFIER));
+    append<uint32_t>(header, FORMAT_R8G8B8A8_UNORM);
+    append<uint32_t>(header, width);
+    append<uint32_t>(header, height);
+    append<uint32_t>(header, uint32_t(levels.size()));
+    append<uint32_t>(header, TILE_WIDTH);
+    append<uint32_t>(header, TILE_HEIGHT);
+    append<uint32_t>(header, TILE_SIZE);
+    append<uint32_t>(header, 0);
+
+    // levels follow header from the largest one
+    uint64_t offset = HEADER_SIZE + levels.size() * LEVEL_INDEX_ENTRY_SIZE;
+    for (const auto &level : levels)
+    {
+        append<uint64_t>(header, offset);
+        append<uint32_t>(header, level.tileCountX);
+        append<uint32_t>(header, level.tileCountY);
+        offset += level.tiles.size();
+    }
+
+    const std::string temporaryPath = path + ".tmp";
+    FILE *output = fopen(temporaryPath.c_str(), "wb");
+    if (!output)
+    {
+        return false;
+    }
+
+    bool written = fwrite(header.data(), 1, header.size(), output) == header.size();
+    for (const auto &level : levels)
+    {
+        written = written && fwrite(level.tiles.data(), 1, level.tiles.size(), output) == level.tiles.size();
+    }
+
+    if (fclose(output) != 0 || !written)
+    {
+        remove(temporaryPath.c_str());
+        return false;
+    }
+
+    return rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
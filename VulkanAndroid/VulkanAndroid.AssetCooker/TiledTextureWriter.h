@@ -0,0 +1,37 @@
+#pragma once
+#include "Bitmap.h"
+
+// writes RGBA8 tiled textures (.vtex) in layout read by TiledTextureFile of the application:
+// every level is divided into tiles which are stored row by row, edge tiles are padded by edge texels
+class TiledTextureWriter
+{
+public:
+    // value of VK_FORMAT_R8G8B8A8_UNORM (Vulkan headers aren't required on host)
+    static const uint32_t FORMAT_R8G8B8A8_UNORM = 37;
+
+    // the same as sparse image block of 32-bit format (64 KB) on all devices
+    static const uint32_t TILE_WIDTH = 128;
+    static const uint32_t TILE_HEIGHT = 128;
+
+    TiledTextureWriter(uint32_t width, uint32_t height);
+
+    // levels are added from the largest one
+    void addLevel(const Bitmap &level);
+
+    // writes to temporary file which replaces destination, so readers never see partial file
+    bool write(const std::string &path) const;
+
+private:
+    struct Level
+    {
+        uint32_t tileCountX;
+        uint32_t tileCountY;
+        std::vector<uint8_t> tiles;
+    };
+
+    uint32_t width;
+
+    uint32_t height;
+
+    std::vector<Level> levels;
+};
@@ -0,0 +1,60 @@
+#include "TextureCooker.h"
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: AssetCooker <textures directory> [--manifest <file>] [--jobs <count>] [--force]\n"
+            << "  textures directory - VulkanAndroid.Packaging/assets/textures\n"
+            << "  --manifest - signatures of cooked textures (default: AssetCooker.manifest)\n"
+            << "  --jobs - number of threads (default: number of hardware threads)\n"
+            << "  --force - cook all textures even if they are up to date\n";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    fs::path texturesPath;
+    fs::path manifestPath = "AssetCooker.manifest";
+    uint32_t threadCount = (std::max)(std::thread::hardware_concurrency(), 1u);
+    bool force = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+
+        if (argument == "--manifest" && i + 1 < argc)
+        {
+            manifestPath = argv[++i];
+        }
+        else if (argument == "--jobs" && i + 1 < argc)
+        {
+            threadCount = uint32_t(std::stoul(argv[++i]));
+        }
+        else if (argument == "--force")
+        {
+            force = true;
+        }
+        else if (texturesPath.empty() && argument[0] != '-')
+        {
+            texturesPath = argument;
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (texturesPath.empty() || !fs::is_directory(texturesPath))
+    {
+        printUsage();
+        return 1;
+    }
+
+    TextureCooker cooker(texturesPath, manifestPath);
+
+    return cooker.cook(threadCount, force) == 0 ? 0 : 1;
+}
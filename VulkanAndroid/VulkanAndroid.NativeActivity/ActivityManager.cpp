@@ -47,6 +47,67 @@ std::vector<uint8_t> ActivityManager::readAsset(const std::string &path)
     return buffer;
 }
 
+AssetView ActivityManager::open(const std::string &path)
+{
+    const std::string fullPath = getExternalStoragePath() + path;
+    AssetView view(fullPath);
+
+    LOGA(!view.isEmpty());
+
+    LOGD("Open file from external storage: [%s]", fullPath.c_str());
+
+    return view;
+}
+
+AssetView ActivityManager::openAsset(const std::string &path)
+{
+    LOGA(activity);
+
+    // random mode, so only accessed pages are read
+    AAsset *asset = AAssetManager_open(activity->assetManager, path.c_str(), AASSET_MODE_RANDOM);
+
+    LOGA(asset);
+
+    LOGD("Open file from assets: [%s]", path.c_str());
+
+    return AssetView(asset);
+}
+
+bool ActivityManager::hasAsset(const std::string &path)
+{
+    LOGA(activity);
+
+    AAsset *asset = AAssetManager_open(activity->assetManager, path.c_str(), AASSET_MODE_UNKNOWN);
+
+    if (asset)
+    {
+        AAsset_close(asset);
+    }
+
+    return asset != nullptr;
+}
+
+bool ActivityManager::write(const std::string &path, const std::string &data)
+{
+    LOGA(activity);
+
+    const std::string fullPath = std::string(activity->internalDataPath) + "/" + path;
+    std::ofstream file(fullPath, std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        LOGE("Failed to write file: [%s]", fullPath.c_str());
+        return false;
+    }
+
+    file << data;
+    file.close();
+
+    LOGD("Write file to internal storage: [%s]", fullPath.c_str());
+
+    return true;
+}
+
 std::vector<std::string> ActivityManager::getFilePaths(
     const std::string &path,
     const std::vector<std::string> &extensions)
@@ -1,5 +1,6 @@
 #pragma once
 #include "android_native_app_glue.h"
+#include "AssetView.h"
 
 class ActivityManager
 {
@@ -10,6 +11,17 @@ public:
 
     static std::vector<uint8_t> readAsset(const std::string &path);
 
+    // view of file from external storage without copying (see AssetView)
+    static AssetView open(const std::string &path);
+
+    // view of asset without copying, asset must exist
+    static AssetView openAsset(const std::string &path);
+
+    static bool hasAsset(const std::string &path);
+
+    // writes text file to internal storage of application, path is relative to it
+    static bool write(const std::string &path, const std::string &data);
+
     static std::vector<std::string> getFilePaths(const std::string &path, const std::vector<std::string> &extensions);
 
 private:
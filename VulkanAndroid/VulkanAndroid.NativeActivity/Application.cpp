@@ -1,14 +1,35 @@
 #include "Application.h"
 #include "ActivityManager.h"
 #include "MotionEvent.h"
+#include "ChoreographerVsyncSource.h"
+#include "TimerVsyncSource.h"
 
-Application::Application(android_app *app) : app(app)
+Application::Application(android_app *app) : app(app), engine(FRAME_COUNT, SWAPCHAIN_POLICY, IDLE_FPS)
 {
     ActivityManager::init(app->activity);
 
     app->userData = &engine;
     app->onAppCmd = handleAppCommand;
     app->onInputEvent = handleAppInput;
+
+    if (ChoreographerVsyncSource::isSupported())
+    {
+        vsyncSource = new ChoreographerVsyncSource();
+        LOGI("Vsync source: choreographer.");
+    }
+    else
+    {
+        vsyncSource = new TimerVsyncSource(DEFAULT_VSYNC_PERIOD);
+        LOGI("Vsync source: timer.");
+    }
+
+    framePacer = new FramePacer(vsyncSource, MAX_FPS);
+}
+
+Application::~Application()
+{
+    delete framePacer;
+    delete vsyncSource;
 }
 
 void Application::mainLoop()
@@ -18,7 +39,8 @@ void Application::mainLoop()
 
     while (true)
     {
-        while (ALooper_pollAll(0, nullptr, &events, reinterpret_cast<void**>(&source)) >= 0)
+        // sleep until next frame, events are handled while waiting
+        while (ALooper_pollAll(framePacer->getTimeoutMillis(), nullptr, &events, reinterpret_cast<void**>(&source)) >= 0)
         {
             if (source)
             {
@@ -32,6 +54,7 @@ void Application::mainLoop()
             }
         }
 
+        framePacer->beginFrame();
         engine.drawFrame();
     }
 }
@@ -63,6 +86,10 @@ void Application::handleAppCommand(android_app *app, int32_t cmd)
         LOGD("APP_CMD_LOST_FOCUS");
         engine->pause();
         break;
+    case APP_CMD_LOW_MEMORY:
+        LOGD("APP_CMD_LOW_MEMORY");
+        engine->dumpMemoryReport();
+        break;
     default: ;
     }
 }
@@ -1,21 +1,41 @@
 #pragma once
 #include "android_native_app_glue.h"
 #include "Engine.h"
+#include "FramePacer.h"
 
 class Application
 {
 public:
     Application(android_app *app);
 
-    ~Application() = default;
+    ~Application();
 
     void mainLoop();
 
 private:
+    // frames in flight: 1 - lowest latency, 3 - highest throughput
+    const uint32_t FRAME_COUNT = 2;
+
+    // low latency for responsive touch, high throughput for stable frame rate
+    const SwapChain::Policy SWAPCHAIN_POLICY = SwapChain::POLICY_LOW_LATENCY;
+
+    // frame rate cap, 0 - display refresh rate
+    const float MAX_FPS = 0;
+
+    // frame rate of static scene with rotating earth, 0 - static scene isn't rendered
+    const float IDLE_FPS = 10.0f;
+
+    // vsync period when choreographer isn't available
+    const nanoseconds DEFAULT_VSYNC_PERIOD{ 16666667 };
+
     android_app *app;
 
     Engine engine;
 
+    VsyncSource *vsyncSource;
+
+    FramePacer *framePacer;
+
     static void handleAppCommand(android_app *app, int32_t cmd);
 
     static int32_t handleAppInput(android_app *app, AInputEvent *event);
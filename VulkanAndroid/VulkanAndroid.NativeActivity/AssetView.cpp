@@ -0,0 +1,152 @@
+#include "AssetView.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+
+AssetView::AssetView(AAsset *asset)
+{
+    LOGA(asset);
+
+    // descriptor is available only for assets which are stored without compression
+    off64_t start;
+    off64_t length;
+    const int fd = AAsset_openFileDescriptor64(asset, &start, &length);
+    if (fd >= 0)
+    {
+        const bool mapped = map(fd, start, size_t(length));
+        close(fd);
+
+        if (mapped)
+        {
+            AAsset_close(asset);
+            return;
+        }
+    }
+
+    this->asset = asset;
+    data = static_cast<const uint8_t*>(AAsset_getBuffer(asset));
+    size = size_t(AAsset_getLength64(asset));
+
+    LOGA(data || size == 0);
+}
+
+AssetView::AssetView(const std::string &path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) == 0 && !map(fd, 0, size_t(fileStat.st_size)))
+    {
+        LOGE("Failed to map file: [%s]", path.c_str());
+    }
+
+    close(fd);
+}
+
+AssetView::AssetView(AssetView &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+AssetView& AssetView::operator=(AssetView &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+
+        std::swap(asset, other.asset);
+        std::swap(mapping, other.mapping);
+        std::swap(mappingSize, other.mappingSize);
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+    }
+
+    return *this;
+}
+
+AssetView::~AssetView()
+{
+    release();
+}
+
+const uint8_t* AssetView::getData() const
+{
+    return data;
+}
+
+size_t AssetView::getSize() const
+{
+    return size;
+}
+
+bool AssetView::isEmpty() const
+{
+    return size == 0;
+}
+
+void AssetView::prefetch(size_t offset, size_t size) const
+{
+    const size_t end = offset + (std::min)(size, this->size - (std::min)(offset, this->size));
+    if (!mapping || offset >= end)
+    {
+        return;
+    }
+
+    // one byte of each page is enough to read it
+    const size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+    volatile uint8_t sum = 0;
+    for (size_t i = offset; i < end; i += pageSize)
+    {
+        sum += data[i];
+    }
+    sum += data[end - 1];
+}
+
+bool AssetView::map(int fd, off64_t offset, size_t size)
+{
+    if (size == 0)
+    {
+        return false;
+    }
+
+    const off64_t pageSize = off64_t(sysconf(_SC_PAGESIZE));
+    const off64_t alignedOffset = offset / pageSize * pageSize;
+    const size_t alignedSize = size + size_t(offset - alignedOffset);
+
+    void *result = mmap64(nullptr, alignedSize, PROT_READ, MAP_PRIVATE, fd, alignedOffset);
+    if (result == MAP_FAILED)
+    {
+        return false;
+    }
+
+    mapping = result;
+    mappingSize = alignedSize;
+    data = static_cast<const uint8_t*>(mapping) + (offset - alignedOffset);
+    this->size = size;
+
+    return true;
+}
+
+void AssetView::release()
+{
+    if (mapping)
+    {
+        munmap(mapping, mappingSize);
+    }
+    if (asset)
+    {
+        AAsset_close(asset);
+    }
+
+    asset = nullptr;
+    mapping = nullptr;
+    mappingSize = 0;
+    data = nullptr;
+    size = 0;
+}
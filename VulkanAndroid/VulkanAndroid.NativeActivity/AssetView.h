@@ -0,0 +1,56 @@
+#pragma once
+#include <android/asset_manager.h>
+
+// read-only view of whole asset or file without copying to heap:
+// uncompressed assets and files are memory-mapped (pages are read from storage on first access),
+// compressed assets are inflated by asset manager (AAsset_getBuffer);
+// data is valid while view exists and doesn't move with view, so it can be read by several threads
+class AssetView
+{
+public:
+    AssetView() = default;
+
+    // asset is closed by view
+    explicit AssetView(AAsset *asset);
+
+    // file of file system, view is empty if file can't be opened
+    explicit AssetView(const std::string &path);
+
+    AssetView(AssetView &&other) noexcept;
+
+    AssetView& operator=(AssetView &&other) noexcept;
+
+    AssetView(const AssetView&) = delete;
+
+    AssetView& operator=(const AssetView&) = delete;
+
+    ~AssetView();
+
+    const uint8_t* getData() const;
+
+    size_t getSize() const;
+
+    bool isEmpty() const;
+
+    // reads pages of range from storage in advance (on worker thread),
+    // so copying of range (to staging buffer) doesn't wait for storage
+    void prefetch(size_t offset, size_t size) const;
+
+private:
+    // asset which owns inflated data, nullptr if data is mapped
+    AAsset *asset = nullptr;
+
+    // mapping starts at page boundary before data
+    void *mapping = nullptr;
+
+    size_t mappingSize = 0;
+
+    const uint8_t *data = nullptr;
+
+    size_t size = 0;
+
+    // returns false if range of file can't be mapped
+    bool map(int fd, off64_t offset, size_t size);
+
+    void release();
+};
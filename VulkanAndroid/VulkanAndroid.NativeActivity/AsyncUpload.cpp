@@ -0,0 +1,257 @@
+#include "AsyncUpload.h"
+#include "StagingBuffer.h"
+
+AsyncUpload::AsyncUpload(Device *device, bool graphicsQueue) : device(device)
+{
+    const QueueFamilyIndices queueFamilyIndices = device->getQueueFamilyIndices();
+    graphicsFamilyIndex = queueFamilyIndices.getGraphics();
+
+    if (graphicsQueue)
+    {
+        queue = device->getGraphicsQueue();
+        commandPool = device->getCommandPool();
+        queueFamilyIndex = graphicsFamilyIndex;
+    }
+    else
+    {
+        queue = device->getTransferQueue();
+        commandPool = device->getTransferCommandPool();
+        queueFamilyIndex = queueFamilyIndices.getTransfer();
+    }
+
+    VkFenceCreateInfo fenceInfo{
+        VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+        nullptr,
+        0
+    };
+    CALL_VK(vkCreateFence(device->get(), &fenceInfo, nullptr, &fence));
+
+    if (queueFamilyIndex != graphicsFamilyIndex)
+    {
+        VkSemaphoreCreateInfo semaphoreInfo{
+            VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+            nullptr,
+            0
+        };
+        CALL_VK(vkCreateSemaphore(device->get(), &semaphoreInfo, nullptr, &transferSemaphore));
+    }
+}
+
+AsyncUpload::~AsyncUpload()
+{
+    if (isPending())
+    {
+        CALL_VK(vkWaitForFences(device->get(), 1, &fence, true, UINT64_MAX));
+    }
+
+    if (transferCommands)
+    {
+        freeTransferCommands();
+    }
+    if (acquireCommands)
+    {
+        vkFreeCommandBuffers(device->get(), device->getCommandPool(), 1, &acquireCommands);
+    }
+
+    vkDestroySemaphore(device->get(), transferSemaphore, nullptr);
+    vkDestroyFence(device->get(), fence, nullptr);
+}
+
+VkCommandBuffer AsyncUpload::begin()
+{
+    LOGA(state == STATE_IDLE);
+
+    transferCommands = allocateCommandBuffer(commandPool);
+    if (queueFamilyIndex != graphicsFamilyIndex)
+    {
+        acquireCommands = allocateCommandBuffer(device->getCommandPool());
+    }
+
+    state = STATE_RECORDING;
+
+    return transferCommands;
+}
+
+void AsyncUpload::finishImage(Image *image, VkImageLayout oldLayout, VkImageLayout newLayout, VkImageSubresourceRange range)
+{
+    LOGA(state == STATE_RECORDING);
+
+    if (queueFamilyIndex == graphicsFamilyIndex)
+    {
+        image->memoryBarrier(
+            transferCommands,
+            oldLayout,
+            newLayout,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            range);
+
+        return;
+    }
+
+    // concurrently shared image is available to both families, only execution and memory are synchronized
+    const bool concurrent = image->isConcurrent();
+    const uint32_t srcQueueFamilyIndex = concurrent ? VK_QUEUE_FAMILY_IGNORED : queueFamilyIndex;
+    const uint32_t dstQueueFamilyIndex = concurrent ? VK_QUEUE_FAMILY_IGNORED : graphicsFamilyIndex;
+
+    // release, layout of exclusively owned range is transitioned by both barriers (as one transition)
+    image->memoryBarrier(
+        transferCommands,
+        oldLayout,
+        newLayout,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        0,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        range,
+        srcQueueFamilyIndex,
+        dstQueueFamilyIndex);
+
+    // acquire, frames which are submitted later sample range after this barrier
+    image->memoryBarrier(
+        acquireCommands,
+        concurrent ? newLayout : oldLayout,
+        newLayout,
+        0,
+        VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        range,
+        srcQueueFamilyIndex,
+        dstQueueFamilyIndex);
+}
+
+VkCommandBuffer AsyncUpload::getGraphicsCommands() const
+{
+    LOGA(state == STATE_RECORDING);
+
+    return acquireCommands ? acquireCommands : transferCommands;
+}
+
+void AsyncUpload::submit(StagingBuffer *stagingBuffer, VkSemaphore waitSemaphore)
+{
+    LOGA(state == STATE_RECORDING);
+
+    CALL_VK(vkEndCommandBuffer(transferCommands));
+    if (acquireCommands)
+    {
+        CALL_VK(vkEndCommandBuffer(acquireCommands));
+    }
+
+    this->stagingBuffer = stagingBuffer;
+
+    submit(queue, transferCommands, waitSemaphore, VK_PIPELINE_STAGE_TRANSFER_BIT, transferSemaphore);
+
+    state = STATE_TRANSFERRING;
+}
+
+bool AsyncUpload::update()
+{
+    if (!isPending())
+    {
+        return false;
+    }
+
+    const VkResult status = vkGetFenceStatus(device->get(), fence);
+    if (status == VK_NOT_READY)
+    {
+        return false;
+    }
+    CALL_VK(status);
+    CALL_VK(vkResetFences(device->get(), 1, &fence));
+
+    if (state == STATE_TRANSFERRING)
+    {
+        freeTransferCommands();
+
+        // copying is completed, so graphics queue doesn't actually wait for semaphore
+        if (acquireCommands)
+        {
+            submit(
+                device->getGraphicsQueue(),
+                acquireCommands,
+                transferSemaphore,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                VK_NULL_HANDLE);
+
+            state = STATE_ACQUIRING;
+
+            return false;
+        }
+    }
+    else
+    {
+        vkFreeCommandBuffers(device->get(), device->getCommandPool(), 1, &acquireCommands);
+        acquireCommands = VK_NULL_HANDLE;
+    }
+
+    state = STATE_IDLE;
+
+    return true;
+}
+
+bool AsyncUpload::isPending() const
+{
+    return state == STATE_TRANSFERRING || state == STATE_ACQUIRING;
+}
+
+uint32_t AsyncUpload::getQueueFamilyIndex() const
+{
+    return queueFamilyIndex;
+}
+
+VkCommandBuffer AsyncUpload::allocateCommandBuffer(VkCommandPool pool) const
+{
+    VkCommandBufferAllocateInfo allocInfo{
+        VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        nullptr,
+        pool,
+        VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        1,
+    };
+
+    VkCommandBuffer commandBuffer;
+    CALL_VK(vkAllocateCommandBuffers(device->get(), &allocInfo, &commandBuffer));
+
+    VkCommandBufferBeginInfo beginInfo{
+        VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        nullptr,
+        VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        nullptr,
+    };
+    CALL_VK(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+
+    return commandBuffer;
+}
+
+void AsyncUpload::submit(
+    VkQueue submitQueue,
+    VkCommandBuffer commandBuffer,
+    VkSemaphore waitSemaphore,
+    VkPipelineStageFlags waitStage,
+    VkSemaphore signalSemaphore)
+{
+    VkSubmitInfo submitInfo{
+        VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        nullptr,
+        waitSemaphore ? 1u : 0u,
+        &waitSemaphore,
+        &waitStage,
+        1,
+        &commandBuffer,
+        signalSemaphore ? 1u : 0u,
+        &signalSemaphore,
+    };
+    CALL_VK(vkQueueSubmit(submitQueue, 1, &submitInfo, fence));
+}
+
+void AsyncUpload::freeTransferCommands()
+{
+    vkFreeCommandBuffers(device->get(), commandPool, 1, &transferCommands);
+    transferCommands = VK_NULL_HANDLE;
+
+    delete stagingBuffer;
+    stagingBuffer = nullptr;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "Image.h"
+
+class StagingBuffer;
+
+// upload of streamed data which is submitted to transfer queue (usually served by DMA engine)
+// and completed without blocking: images written by transfer queue family are released by it
+// and acquired by graphics queue family after completion of copying, so acquisition doesn't stall frames;
+// if transfer family is graphics family, upload is submitted to graphics queue without ownership transfer
+class AsyncUpload
+{
+public:
+    // graphicsQueue - upload is submitted to graphics queue (e.g. its copies don't match transfer granularity)
+    explicit AsyncUpload(Device *device, bool graphicsQueue = false);
+
+    // waits for pending upload
+    ~AsyncUpload();
+
+    // starts recording of new upload, previous one must be completed
+    VkCommandBuffer begin();
+
+    // records barriers which make range of image written by transfer commands visible to fragment shaders,
+    // exclusively owned range is released by upload queue family and acquired by graphics family
+    void finishImage(Image *image, VkImageLayout oldLayout, VkImageLayout newLayout, VkImageSubresourceRange range);
+
+    // commands which are executed by graphics queue after copying and finishing of images (while recording),
+    // they are ordered with frames which are submitted to graphics queue before and after them
+    VkCommandBuffer getGraphicsCommands() const;
+
+    // submits recorded commands which wait for semaphore (if it isn't null) before copying,
+    // staging buffer is destroyed when upload is completed
+    void submit(StagingBuffer *stagingBuffer, VkSemaphore waitSemaphore = VK_NULL_HANDLE);
+
+    // continues upload (must be called regularly by thread which owns device queues),
+    // returns true when the last upload is completed and uploaded data can be sampled
+    bool update();
+
+    // upload is submitted and isn't completed yet
+    bool isPending() const;
+
+    // family of queue which executes transfer commands
+    uint32_t getQueueFamilyIndex() const;
+
+private:
+    enum State
+    {
+        STATE_IDLE,
+        STATE_RECORDING,
+        STATE_TRANSFERRING,
+        STATE_ACQUIRING
+    };
+
+    Device *device;
+
+    VkQueue queue;
+
+    VkCommandPool commandPool;
+
+    uint32_t queueFamilyIndex;
+
+    uint32_t graphicsFamilyIndex;
+
+    State state = STATE_IDLE;
+
+    VkCommandBuffer transferCommands = VK_NULL_HANDLE;
+
+    // recorded together with transfer commands, but submitted to graphics queue after them
+    VkCommandBuffer acquireCommands = VK_NULL_HANDLE;
+
+    StagingBuffer *stagingBuffer = nullptr;
+
+    // signaled by transfer queue, awaited by acquisition
+    VkSemaphore transferSemaphore = VK_NULL_HANDLE;
+
+    VkFence fence;
+
+    VkCommandBuffer allocateCommandBuffer(VkCommandPool pool) const;
+
+    void submit(
+        VkQueue submitQueue,
+        VkCommandBuffer commandBuffer,
+        VkSemaphore waitSemaphore,
+        VkPipelineStageFlags waitStage,
+        VkSemaphore signalSemaphore);
+
+    void freeTransferCommands();
+};
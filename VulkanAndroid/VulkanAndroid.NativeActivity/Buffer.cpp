@@ -1,20 +1,44 @@
 #include "Buffer.h"
+#include "StagingRing.h"
+#include <algorithm>
 
-Buffer::Buffer(Device *device, VkBufferUsageFlags usage, VkDeviceSize size) : StagingBuffer(device, size)
+Buffer::Buffer(Device *device, VkBufferUsageFlags usage, VkDeviceSize size) : device(device), size(size)
 {
-	createBuffer(
-		device,
+	VkBufferCreateInfo createInfo{
+		VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+		nullptr,
+		0,
 		size,
 		usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-		&buffer,
-		&memory);
+		VK_SHARING_MODE_EXCLUSIVE,
+		0,
+		nullptr,
+	};
+
+	CALL_VK(vkCreateBuffer(device->get(), &createInfo, nullptr, &buffer));
+
+	// unified memory type can be unavailable for this usage of buffer
+	VkMemoryRequirements memRequirements;
+	vkGetBufferMemoryRequirements(device->get(), buffer, &memRequirements);
+	hostVisible = device->unifiedMemoryEnabled() && 
+		device->hasMemoryType(memRequirements.memoryTypeBits, UNIFIED_MEMORY_PROPERTIES);
+
+	StagingBuffer::allocateMemory(
+		device,
+		buffer,
+		&memory,
+		hostVisible ? UNIFIED_MEMORY_PROPERTIES : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		0,
+		MemoryAllocator::STRATEGY_LINEAR,
+		usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT ? MemoryAllocator::CATEGORY_UNIFORM : MemoryAllocator::CATEGORY_VERTEX_INDEX);
+
+	vkBindBufferMemory(device->get(), buffer, memory.memory, memory.offset);
 }
 
 Buffer::~Buffer()
 {
-	vkFreeMemory(device->get(), memory, nullptr);
 	vkDestroyBuffer(device->get(), buffer, nullptr);
+	device->getMemoryAllocator()->free(memory);
 }
 
 VkBuffer Buffer::get() const
@@ -22,6 +46,16 @@ VkBuffer Buffer::get() const
 	return buffer;
 }
 
+VkDeviceSize Buffer::getSize() const
+{
+    return size;
+}
+
+bool Buffer::isHostVisible() const
+{
+    return hostVisible;
+}
+
 DescriptorInfo Buffer::getUniformBufferInfo() const
 {
     DescriptorInfo info;
@@ -41,14 +75,33 @@ void Buffer::updateData(const void *data, VkDeviceSize offset, VkDeviceSize data
         dataSize = size - offset;
     }
 
-	StagingBuffer::updateData(data, offset, dataSize);
+    LOGA(offset + dataSize <= size);
 
-	VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
-	VkBufferCopy region{
-		offset,
-		offset,	
-		dataSize,
-	};
-	vkCmdCopyBuffer(commandBuffer, stagingBuffer, buffer, 1, &region);
-	device->endOneTimeCommands(commandBuffer);
+    if (hostVisible)
+    {
+        memcpy(memory.mappedData + offset, data, dataSize);
+        return;
+    }
+
+    StagingRing *stagingRing = device->getStagingRing();
+
+    // data larger than staging ring is uploaded by parts
+    for (VkDeviceSize copied = 0; copied < dataSize;)
+    {
+        const VkDeviceSize partSize = (std::min)(dataSize - copied, stagingRing->getCapacity());
+
+        const StagingRing::Region stagingRegion = stagingRing->allocate(partSize);
+        memcpy(stagingRegion.data, reinterpret_cast<const uint8_t*>(data) + copied, partSize);
+
+        VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
+        VkBufferCopy region{
+            stagingRegion.offset,
+            offset + copied,
+            partSize,
+        };
+        vkCmdCopyBuffer(commandBuffer, stagingRegion.buffer, buffer, 1, &region);
+        device->endOneTimeCommands(commandBuffer);
+
+        copied += partSize;
+    }
 }
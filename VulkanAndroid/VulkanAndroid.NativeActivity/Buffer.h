@@ -1,9 +1,11 @@
 #pragma once
-#include "StagingBuffer.h"
+#include "Device.h"
 #include "DescriptorInfo.h"
+#include "MemoryAllocator.h"
 
-// buffer with device local memory 
-class Buffer : public StagingBuffer
+// buffer with device local memory, data is uploaded through staging ring of device;
+// with unified memory buffer is persistently mapped and data is copied directly
+class Buffer
 {
 public:
 	Buffer(Device *device, VkBufferUsageFlags usage, VkDeviceSize size);
@@ -11,13 +13,27 @@ public:
 
 	VkBuffer get() const;
 
+    VkDeviceSize getSize() const;
+
     DescriptorInfo getUniformBufferInfo() const;
 
-	void updateData(const void *data, VkDeviceSize offset = 0, VkDeviceSize dataSize = VkDeviceSize(-1)) override;
+	// memory is host visible, so data is written without staging and submissions
+	bool isHostVisible() const;
+
+	void updateData(const void *data, VkDeviceSize offset = 0, VkDeviceSize dataSize = VkDeviceSize(-1));
 
 private:
+	const VkMemoryPropertyFlags UNIFIED_MEMORY_PROPERTIES =
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+	Device *device;
+
 	VkBuffer buffer;
 
-	VkDeviceMemory memory;
+	VkDeviceSize size;
+
+	MemoryAllocator::Allocation memory;
+
+	bool hostVisible;
 };
 
@@ -1,17 +1,16 @@
 #include "Camera.h"
 
-Camera::Camera(Device *device, Parameters parameters, Location location) : parameters(parameters)
+Camera::Camera(RingBuffer *uniformBuffer, Parameters parameters, Location location)
+    : parameters(parameters),
+      location(location),
+      uniformBuffer(uniformBuffer)
 {
-    glm::mat4 matrices[2] = { createViewMatrix(), createProjectionMatrix() };
+    projection = createProjectionMatrix();
 
-    buffer = new Buffer(device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof matrices);
-    buffer->updateData(matrices);
+    bufferOffset = uniformBuffer->allocate(2 * sizeof(glm::mat4));
 }
 
-Camera::~Camera()
-{
-    delete buffer;
-}
+Camera::~Camera() = default;
 
 glm::vec3 Camera::getPosition() const
 {
@@ -34,24 +33,28 @@ glm::vec3 Camera::getRight() const
     return glm::cross(forward, location.up);
 }
 
-Buffer* Camera::getBuffer() const
+float Camera::getPixelAngle() const
+{
+    return glm::radians(calculateFovY()) / float(parameters.extent.height);
+}
+
+DescriptorInfo Camera::getBufferInfo() const
 {
-    return buffer;
+    return uniformBuffer->getUniformBufferInfo(bufferOffset, 2 * sizeof(glm::mat4));
 }
 
 void Camera::update(Location location)
 {
     this->location = location;
 
-    glm::mat4 view = createViewMatrix();
-    buffer->updateData(&view, 0, sizeof(glm::mat4));
+    glm::mat4 matrices[2] = { createViewMatrix(), projection };
+    uniformBuffer->updateData(matrices, bufferOffset, sizeof matrices);
 }
 
 void Camera::resize(VkExtent2D newExtent)
 {
     parameters.extent = newExtent;
-    glm::mat4 projection = createProjectionMatrix();
-    buffer->updateData(&projection, sizeof(glm::mat4), sizeof(glm::mat4));
+    projection = createProjectionMatrix();
 }
 
 glm::mat4 Camera::createViewMatrix() const
@@ -63,7 +66,7 @@ glm::mat4 Camera::createProjectionMatrix() const
 {
     const float aspect = parameters.extent.width / float(parameters.extent.height);
 
-    const float fovY = aspect < 1.0f ? parameters.fov : parameters.fov / aspect;
+    const float fovY = calculateFovY();
 
     LOGD("Camera fov x: %f, y: %f", fovY * aspect, fovY);
 
@@ -77,3 +80,10 @@ glm::mat4 Camera::createProjectionMatrix() const
 
     return projection;
 }
+
+float Camera::calculateFovY() const
+{
+    const float aspect = parameters.extent.width / float(parameters.extent.height);
+
+    return aspect < 1.0f ? parameters.fov : parameters.fov / aspect;
+}
@@ -1,7 +1,7 @@
 #pragma once
 #include "Device.h"
 #include <glm/gtx/transform.hpp>
-#include "Buffer.h"
+#include "RingBuffer.h"
 
 class Camera
 {
@@ -21,7 +21,7 @@ public:
         glm::vec3 up;
     };
 
-    Camera(Device *device, Parameters parameters, Location location);
+    Camera(RingBuffer *uniformBuffer, Parameters parameters, Location location);
 
     ~Camera();
 
@@ -33,8 +33,12 @@ public:
 
     glm::vec3 getRight() const;
 
-    Buffer* getBuffer() const;
+    // vertical angle of one pixel in radians (at the center of viewport)
+    float getPixelAngle() const;
 
+    DescriptorInfo getBufferInfo() const;
+
+    // writes view and projection matrices to current frame of uniform buffer
     void update(Location location);
 
     void resize(VkExtent2D newExtent);
@@ -44,10 +48,17 @@ private:
 
     Location location;
 
-    Buffer *buffer;
+    glm::mat4 projection;
+
+    RingBuffer *uniformBuffer;
+
+    VkDeviceSize bufferOffset;
 
     glm::mat4 createViewMatrix() const;
 
     glm::mat4 createProjectionMatrix() const;
+
+    // vertical field of view in degrees
+    float calculateFovY() const;
 };
 
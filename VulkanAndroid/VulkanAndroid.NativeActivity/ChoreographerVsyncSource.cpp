@@ -0,0 +1,135 @@
+#include "ChoreographerVsyncSource.h"
+#include <dlfcn.h>
+#include <time.h>
+
+// choreographer functions aren't available at API level of project,
+// so they are loaded from libandroid.so
+namespace
+{
+    struct AChoreographer;
+
+    typedef void (*AChoreographer_frameCallback)(long frameTimeNanos, void *data);
+
+    typedef void (*AChoreographer_frameCallback64)(int64_t frameTimeNanos, void *data);
+
+    typedef AChoreographer* (*PFN_AChoreographer_getInstance)();
+
+    typedef void (*PFN_AChoreographer_postFrameCallback)(
+        AChoreographer *choreographer, 
+        AChoreographer_frameCallback callback, 
+        void *data);
+
+    typedef void (*PFN_AChoreographer_postFrameCallback64)(
+        AChoreographer *choreographer,
+        AChoreographer_frameCallback64 callback,
+        void *data);
+
+    PFN_AChoreographer_getInstance AChoreographer_getInstance = nullptr;
+
+    PFN_AChoreographer_postFrameCallback AChoreographer_postFrameCallback = nullptr;
+
+    PFN_AChoreographer_postFrameCallback64 AChoreographer_postFrameCallback64 = nullptr;
+
+    bool loadChoreographer()
+    {
+        if (AChoreographer_getInstance && (AChoreographer_postFrameCallback64 || AChoreographer_postFrameCallback))
+        {
+            return true;
+        }
+
+        void *libandroid = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+        if (!libandroid)
+        {
+            return false;
+        }
+
+        AChoreographer_getInstance = reinterpret_cast<PFN_AChoreographer_getInstance>(
+            dlsym(libandroid, "AChoreographer_getInstance"));
+        AChoreographer_postFrameCallback64 = reinterpret_cast<PFN_AChoreographer_postFrameCallback64>(
+            dlsym(libandroid, "AChoreographer_postFrameCallback64"));
+
+        // deprecated since API 29
+        if (!AChoreographer_postFrameCallback64)
+        {
+            AChoreographer_postFrameCallback = reinterpret_cast<PFN_AChoreographer_postFrameCallback>(
+                dlsym(libandroid, "AChoreographer_postFrameCallback"));
+        }
+
+        return AChoreographer_getInstance && (AChoreographer_postFrameCallback64 || AChoreographer_postFrameCallback);
+    }
+}
+
+ChoreographerVsyncSource::ChoreographerVsyncSource() : lastVsync(steady_clock::now()), period(DEFAULT_PERIOD)
+{
+    LOGA(loadChoreographer());
+
+    postFrameCallback();
+}
+
+bool ChoreographerVsyncSource::isSupported()
+{
+    return loadChoreographer();
+}
+
+time_point<steady_clock> ChoreographerVsyncSource::getNextVsync(time_point<steady_clock> timePoint) const
+{
+    if (timePoint <= lastVsync)
+    {
+        return lastVsync;
+    }
+
+    // extrapolate from the last reported vsync
+    const auto periodCount = (timePoint - lastVsync + period - nanoseconds(1)) / period;
+
+    return lastVsync + periodCount * period;
+}
+
+void ChoreographerVsyncSource::postFrameCallback()
+{
+    if (AChoreographer_postFrameCallback64)
+    {
+        AChoreographer_postFrameCallback64(AChoreographer_getInstance(), handleFrame64, this);
+    }
+    else
+    {
+        AChoreographer_postFrameCallback(AChoreographer_getInstance(), handleFrame, this);
+    }
+}
+
+void ChoreographerVsyncSource::updateVsync(nanoseconds frameTime)
+{
+    // frame time is in CLOCK_MONOTONIC time base as steady_clock
+    const time_point<steady_clock> vsync{ frameTime };
+
+    const nanoseconds delta = vsync - lastVsync;
+    if (delta > nanoseconds(0) && delta < MAX_PERIOD)
+    {
+        period = delta;
+    }
+
+    lastVsync = vsync;
+
+    // callback is called only once
+    postFrameCallback();
+}
+
+void ChoreographerVsyncSource::handleFrame64(int64_t frameTimeNanos, void *data)
+{
+    reinterpret_cast<ChoreographerVsyncSource*>(data)->updateVsync(nanoseconds(frameTimeNanos));
+}
+
+void ChoreographerVsyncSource::handleFrame(long frameTimeNanos, void *data)
+{
+    if (sizeof(long) >= sizeof(int64_t))
+    {
+        reinterpret_cast<ChoreographerVsyncSource*>(data)->updateVsync(nanoseconds(frameTimeNanos));
+        return;
+    }
+
+    // long is 32-bit on armeabi-v7a and x86, so frame time wraps around every 4.3 s,
+    // time of callback is used instead (it's a bit later than vsync)
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    reinterpret_cast<ChoreographerVsyncSource*>(data)->updateVsync(seconds(now.tv_sec) + nanoseconds(now.tv_nsec));
+}
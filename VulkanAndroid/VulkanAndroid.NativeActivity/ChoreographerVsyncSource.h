@@ -0,0 +1,34 @@
+#pragma once
+#include "VsyncSource.h"
+
+// vsync time points reported by AChoreographer (API 24+, 64-bit frame time since API 29),
+// callbacks are received during polling of the looper of the thread which created the source
+class ChoreographerVsyncSource : public VsyncSource
+{
+public:
+    ChoreographerVsyncSource();
+
+    // checks that AChoreographer functions can be loaded
+    static bool isSupported();
+
+    time_point<steady_clock> getNextVsync(time_point<steady_clock> timePoint) const override;
+
+private:
+    const nanoseconds DEFAULT_PERIOD{ 16666667 };
+
+    // ignore period estimations when frames are skipped by choreographer
+    const nanoseconds MAX_PERIOD{ 50000000 };
+
+    time_point<steady_clock> lastVsync;
+
+    nanoseconds period;
+
+    void postFrameCallback();
+
+    void updateVsync(nanoseconds frameTime);
+
+    static void handleFrame64(int64_t frameTimeNanos, void *data);
+
+    static void handleFrame(long frameTimeNanos, void *data);
+};
+
@@ -2,15 +2,39 @@
 #include <glm/gtx/transform.hpp>
 #include "ActivityManager.h"
 
-Clouds::Clouds(Device *device, const std::string &texturePath) : Model(device)
+Clouds::Clouds(
+    Device *device,
+    TextureLoader *textureLoader,
+    TextureStreamer *textureStreamer,
+    RingBuffer *uniformBuffer,
+    const std::string &texturePath)
+    : Model(uniformBuffer)
 {
-    texture = new TextureImage(
-        device,
-        { ActivityManager::readAsset(texturePath + TEXTURE_FILE) },
+    // compressed or KTX 2.0 version of texture with pre-generated mip levels is preferred
+    const std::string path = TextureImage::findAsset(device, texturePath + TEXTURE_FILE);
+
+    // only mip tail is loaded before the first frame, streamed texture has its own view
+    StreamingTexture *streamingTexture = textureStreamer->load(path, false);
+    if (streamingTexture)
+    {
+        streamingTexture->pushSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+        texture = streamingTexture;
+        return;
+    }
+
+    // shader samples only red channel, so other channels aren't stored
+    textureLoader->load(
+        path,
+        { [path]() { return ActivityManager::openAsset(path); } },
+        STBI_grey,
         true,
-        false);
-    texture->pushFullView(VK_IMAGE_ASPECT_COLOR_BIT);
-    texture->pushSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+        false,
+        [this](TextureImage *loadedTexture)
+        {
+            loadedTexture->pushFullView(VK_IMAGE_ASPECT_COLOR_BIT);
+            loadedTexture->pushSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+            texture = loadedTexture;
+        });
 }
 
 Clouds::~Clouds()
@@ -1,11 +1,18 @@
 #pragma once
 #include "Model.h"
-#include "TextureImage.h"
+#include "TextureLoader.h"
+#include "TextureStreamer.h"
 
 class Clouds : public Model
 {
 public:
-    Clouds(Device *device, const std::string &texturePath);
+    // KTX 2.0 textures with mip levels are streamed, others are created by loader after decoding
+    Clouds(
+        Device *device,
+        TextureLoader *textureLoader,
+        TextureStreamer *textureStreamer,
+        RingBuffer *uniformBuffer,
+        const std::string &texturePath);
 
     virtual ~Clouds();
 
@@ -67,6 +67,11 @@ void Controller::update(float deltaSec)
     const float zoomFading = ZOOM_FADING * zoomDelta * deltaSec;
     zoomDelta = glm::abs(zoomDelta) > glm::abs(zoomFading) ? zoomDelta - zoomFading : 0.0f;
 
+    // fading never reaches zero itself
+    motionDelta.x = glm::abs(motionDelta.x) > MIN_MOTION_DELTA ? motionDelta.x : 0.0f;
+    motionDelta.y = glm::abs(motionDelta.y) > MIN_MOTION_DELTA ? motionDelta.y : 0.0f;
+    zoomDelta = glm::abs(zoomDelta) > MIN_ZOOM_DELTA ? zoomDelta : 0.0f;
+
     // restricts Y angle
     const float maxY = 85.0f;
     angle.y = glm::clamp(angle.y, -maxY, maxY);
@@ -76,3 +81,8 @@ void Controller::update(float deltaSec)
     const float maxRadius = 45.0f;
     radius = glm::clamp(radius, minRadius, maxRadius);
 }
+
+bool Controller::isMoving() const
+{
+    return motionDelta != glm::vec2(0.0f) || zoomDelta != 0.0f;
+}
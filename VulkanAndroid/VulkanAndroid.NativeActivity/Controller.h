@@ -18,6 +18,10 @@ public:
 
     void update(float deltaSec);
 
+    // camera still moves by inertia of motion or zoom,
+    // inertia stops in bounded time after the last input, so scene becomes idle
+    bool isMoving() const;
+
 private:
     const float ROTATION_SENSITIVITY = 5.0f;
     const float ROTATION_FADING = 2.0f;
@@ -25,6 +29,10 @@ private:
     const float ZOOM_SENSITIVITY = 1.5f;
     const float ZOOM_FADING = 3.0f;
 
+    // inertia fades exponentially, so it's stopped below invisible deltas
+    const float MIN_MOTION_DELTA = 0.01f;
+    const float MIN_ZOOM_DELTA = 0.01f;
+
     glm::vec3 target;
 
     float radius;
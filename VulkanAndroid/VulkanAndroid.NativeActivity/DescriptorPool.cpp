@@ -137,6 +137,9 @@ void DescriptorPool::updateDescriptorSet(VkDescriptorSet set, DescriptorInfos de
         // case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER: break;
 
         case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+        // offsets of dynamic buffers are added to info offsets when sets are bound
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
             for (auto info : infos)
             {
                 bufferInfos.push_back(info.buffer);
@@ -157,8 +160,6 @@ void DescriptorPool::updateDescriptorSet(VkDescriptorSet set, DescriptorInfos de
             break;
 
         // case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: break;
-        // case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC: break;
-        // case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC: break;
         // case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT: break;
         // case VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK_EXT: break;
         // case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_NV: break;
@@ -1,4 +1,7 @@
 ﻿#include "Device.h"
+#include "UploadContext.h"
+#include "StagingRing.h"
+#include "MemoryAllocator.h"
 
 Device::Device(VkInstance instance, VkSurfaceKHR surface, const std::vector<const char*> &requiredLayers) : surface(surface)
 {
@@ -9,12 +12,36 @@ Device::Device(VkInstance instance, VkSurfaceKHR surface, const std::vector<cons
     LOGD("Physical device: %s.", properties.deviceName);
     LOGD("Maximum sample count: %d.", getMaxSampleCount());
 
+    timelineSemaphoreSupport = checkTimelineSemaphoreSupport(instance);
+    LOGD("Timeline semaphores: %s.", timelineSemaphoreSupport ? "supported" : "not supported");
+
+    logMemoryTypes();
+    unifiedMemorySupport = hasMemoryType(
+        ~0u, 
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    LOGD("Unified memory: %s.", unifiedMemorySupport ? "supported" : "not supported");
+
+    memoryBudgetSupport = checkMemoryBudgetSupport(instance);
+    LOGD("Memory budget: %s.", memoryBudgetSupport ? "supported" : "not supported");
+
 	createDevice(requiredLayers);
-	createCommandPool();
+
+    const QueueFamilyIndices queueFamilyIndices = getQueueFamilyIndices();
+	commandPool = createCommandPool(queueFamilyIndices.getGraphics());
+    computeCommandPool = createCommandPool(queueFamilyIndices.getCompute());
+    transferCommandPool = createCommandPool(queueFamilyIndices.getTransfer());
+
+    memoryAllocator = new MemoryAllocator(this);
+    stagingRing = new StagingRing(this, STAGING_RING_SIZE);
 }
 
 Device::~Device()
 {
+    delete stagingRing;
+    delete memoryAllocator;
+
+    vkDestroyCommandPool(device, transferCommandPool, nullptr);
+    vkDestroyCommandPool(device, computeCommandPool, nullptr);
 	vkDestroyCommandPool(device, commandPool, nullptr);
 	vkDestroyDevice(device, nullptr);
 }
@@ -34,6 +61,11 @@ VkQueue Device::getComputeQueue() const
     return computeQueue;
 }
 
+VkQueue Device::getTransferQueue() const
+{
+    return transferQueue;
+}
+
 VkQueue Device::getPresentQueue() const
 {
 	return presentQueue;
@@ -44,6 +76,16 @@ VkCommandPool Device::getCommandPool() const
 	return commandPool;
 }
 
+VkCommandPool Device::getComputeCommandPool() const
+{
+    return computeCommandPool;
+}
+
+VkCommandPool Device::getTransferCommandPool() const
+{
+    return transferCommandPool;
+}
+
 VkFormatProperties Device::getFormatProperties(VkFormat format) const
 {
 	VkFormatProperties formatProperties;
@@ -52,16 +94,73 @@ VkFormatProperties Device::getFormatProperties(VkFormat format) const
 	return formatProperties;
 }
 
+VkExtent3D Device::getSparseImageGranularity(VkFormat format, VkImageUsageFlags usage) const
+{
+    uint32_t propertyCount = 0;
+    vkGetPhysicalDeviceSparseImageFormatProperties(
+        physicalDevice,
+        format,
+        VK_IMAGE_TYPE_2D,
+        VK_SAMPLE_COUNT_1_BIT,
+        usage,
+        VK_IMAGE_TILING_OPTIMAL,
+        &propertyCount,
+        nullptr);
+
+    std::vector<VkSparseImageFormatProperties> properties(propertyCount);
+    vkGetPhysicalDeviceSparseImageFormatProperties(
+        physicalDevice,
+        format,
+        VK_IMAGE_TYPE_2D,
+        VK_SAMPLE_COUNT_1_BIT,
+        usage,
+        VK_IMAGE_TILING_OPTIMAL,
+        &propertyCount,
+        properties.data());
+
+    for (const auto &property : properties)
+    {
+        if (property.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT)
+        {
+            return property.imageGranularity;
+        }
+    }
+
+    return VkExtent3D{ 0, 0, 0 };
+}
+
+VkExtent3D Device::getTransferImageGranularity() const
+{
+    uint32_t queueFamilyCount;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    return queueFamilies[getQueueFamilyIndices().getTransfer()].minImageTransferGranularity;
+}
+
 void Device::updateSurface(VkSurfaceKHR surface)
 {
     this->surface = surface;
 }
 
-uint32_t Device::findMemoryTypeIndex(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+uint32_t Device::findMemoryTypeIndex(
+	uint32_t typeFilter,
+	VkMemoryPropertyFlags properties,
+	VkMemoryPropertyFlags preferredProperties) const
 {
 	VkPhysicalDeviceMemoryProperties memProperties;
 	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
 
+	const VkMemoryPropertyFlags allProperties = properties | preferredProperties;
+	for (uint32_t i = 0; i < memProperties.memoryTypeCount && preferredProperties; i++)
+	{
+		if (typeFilter & (1 << i) && (memProperties.memoryTypes[i].propertyFlags & allProperties) == allProperties)
+		{
+			return i;
+		}
+	}
+
 	for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
 	{
 		if (typeFilter & (1 << i) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
@@ -74,6 +173,27 @@ uint32_t Device::findMemoryTypeIndex(uint32_t typeFilter, VkMemoryPropertyFlags
 	return uint32_t{};
 }
 
+bool Device::hasMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+{
+	VkPhysicalDeviceMemoryProperties memProperties;
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+	for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+	{
+		if (typeFilter & (1 << i) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool Device::unifiedMemoryEnabled() const
+{
+    return unifiedMemorySupport;
+}
+
 VkFormat Device::findSupportedFormat(std::vector<VkFormat> requestedFormats, VkImageTiling tiling, VkFormatFeatureFlags features) const
 {
 	for (auto format : requestedFormats)
@@ -126,8 +246,109 @@ VkSampleCountFlagBits Device::getMaxSampleCount() const
     return VK_SAMPLE_COUNT_1_BIT;
 }
 
+VkPhysicalDeviceLimits Device::getLimits() const
+{
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+
+    return physicalDeviceProperties.limits;
+}
+
+VkPhysicalDeviceMemoryProperties Device::getMemoryProperties() const
+{
+    VkPhysicalDeviceMemoryProperties memProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+    return memProperties;
+}
+
+bool Device::timelineSemaphoresEnabled() const
+{
+    return timelineSemaphoreSupport;
+}
+
+void Device::waitSemaphore(VkSemaphore semaphore, uint64_t value) const
+{
+    LOGA(timelineSemaphoreSupport);
+
+    const VkSemaphoreWaitInfoKHR waitInfo{
+        VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR,
+        nullptr,
+        0,
+        1,
+        &semaphore,
+        &value
+    };
+
+    CALL_VK(vkWaitSemaphoresKHR(device, &waitInfo, UINT64_MAX));
+}
+
+uint64_t Device::getSemaphoreValue(VkSemaphore semaphore) const
+{
+    LOGA(timelineSemaphoreSupport);
+
+    uint64_t value;
+    CALL_VK(vkGetSemaphoreCounterValueKHR(device, semaphore, &value));
+
+    return value;
+}
+
+bool Device::memoryBudgetEnabled() const
+{
+    return memoryBudgetSupport;
+}
+
+bool Device::sparseResidencyEnabled() const
+{
+    return sparseResidencySupport;
+}
+
+VkPhysicalDeviceMemoryBudgetPropertiesEXT Device::getMemoryBudget() const
+{
+    LOGA(memoryBudgetSupport);
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT
+    };
+
+    VkPhysicalDeviceMemoryProperties2KHR memProperties{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2_KHR,
+        &budget,
+        {}
+    };
+
+    vkGetPhysicalDeviceMemoryProperties2KHR(physicalDevice, &memProperties);
+
+    return budget;
+}
+
+void Device::setUploadContext(UploadContext *context)
+{
+    uploadContext = context;
+}
+
+UploadContext* Device::getUploadContext() const
+{
+    return uploadContext;
+}
+
+MemoryAllocator* Device::getMemoryAllocator() const
+{
+    return memoryAllocator;
+}
+
+StagingRing* Device::getStagingRing() const
+{
+    return stagingRing;
+}
+
 VkCommandBuffer Device::beginOneTimeCommands() const
 {
+    if (uploadContext)
+    {
+        return uploadContext->getCommandBuffer();
+    }
+
 	VkCommandBuffer commandBuffer;
 
 	VkCommandBufferAllocateInfo allocInfo{
@@ -154,6 +375,11 @@ VkCommandBuffer Device::beginOneTimeCommands() const
 
 void Device::endOneTimeCommands(VkCommandBuffer commandBuffer) const
 {
+    if (uploadContext)
+    {
+        return;
+    }
+
 	CALL_VK(vkEndCommandBuffer(commandBuffer));
 
 	VkSubmitInfo submitInfo{
@@ -168,9 +394,12 @@ void Device::endOneTimeCommands(VkCommandBuffer commandBuffer) const
 		nullptr,
 	};
 
-	CALL_VK(vkQueueSubmit(computeQueue, 1, &submitInfo, VK_NULL_HANDLE));
+	CALL_VK(vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE));
+	stagingRing->submit(graphicsQueue);
+
+	vkQueueWaitIdle(graphicsQueue);
 
-	vkQueueWaitIdle(computeQueue);
+	stagingRing->update();
 
 	vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
 }
@@ -249,12 +478,61 @@ bool Device::checkDeviceExtensionSupport(VkPhysicalDevice device, const std::vec
 	return requiredExtensionSet.empty();
 }
 
+bool Device::checkTimelineSemaphoreSupport(VkInstance instance) const
+{
+    if (!checkDeviceExtensionSupport(physicalDevice, { VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME }))
+    {
+        return false;
+    }
+
+    // available only if instance has VK_KHR_get_physical_device_properties2
+    const auto getFeatures2 = PFN_vkGetPhysicalDeviceFeatures2KHR(
+        vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2KHR"));
+
+    if (getFeatures2 == nullptr)
+    {
+        return false;
+    }
+
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+        nullptr,
+        false
+    };
+
+    VkPhysicalDeviceFeatures2KHR features{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR,
+        &timelineFeatures,
+        {}
+    };
+
+    getFeatures2(physicalDevice, &features);
+
+    return timelineFeatures.timelineSemaphore;
+}
+
+bool Device::checkMemoryBudgetSupport(VkInstance instance)
+{
+    if (!checkDeviceExtensionSupport(physicalDevice, { VK_EXT_MEMORY_BUDGET_EXTENSION_NAME }))
+    {
+        return false;
+    }
+
+    // available only if instance has VK_KHR_get_physical_device_properties2
+    vkGetPhysicalDeviceMemoryProperties2KHR = PFN_vkGetPhysicalDeviceMemoryProperties2KHR(
+        vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceMemoryProperties2KHR"));
+
+    return vkGetPhysicalDeviceMemoryProperties2KHR != nullptr;
+}
+
 void Device::createDevice(const std::vector<const char*> &layers)
 {
 	QueueFamilyIndices queueFamilyIndices = getQueueFamilyIndices();
 
 	std::set<uint32_t> uniqueQueueFamilyIndices{
 		queueFamilyIndices.getGraphics(),
+        queueFamilyIndices.getCompute(),
+        queueFamilyIndices.getTransfer(),
 		queueFamilyIndices.getPresentation()
 	};
 
@@ -278,36 +556,121 @@ void Device::createDevice(const std::vector<const char*> &layers)
 	VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.shaderStorageImageExtendedFormats = true;
 
+    // compressed textures are used when their formats are supported
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+    deviceFeatures.textureCompressionETC2 = supportedFeatures.textureCompressionETC2;
+    deviceFeatures.textureCompressionASTC_LDR = supportedFeatures.textureCompressionASTC_LDR;
+    deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+    LOGD("Texture compression: ETC2 %d, ASTC %d, BC %d.",
+        supportedFeatures.textureCompressionETC2,
+        supportedFeatures.textureCompressionASTC_LDR,
+        supportedFeatures.textureCompressionBC);
+
+    // virtual textures bind tiles from graphics queue, so it must support sparse binding;
+    // filtering can touch non-resident neighbors of sampled tiles, so they must be read as zeros
+    uint32_t queueFamilyCount;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+
+    sparseResidencySupport = supportedFeatures.sparseBinding
+        && supportedFeatures.sparseResidencyImage2D
+        && physicalDeviceProperties.sparseProperties.residencyNonResidentStrict
+        && (queueFamilies[queueFamilyIndices.getGraphics()].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT);
+    deviceFeatures.sparseBinding = sparseResidencySupport;
+    deviceFeatures.sparseResidencyImage2D = sparseResidencySupport;
+    LOGD("Sparse residency of images: %d.", sparseResidencySupport);
+
+    std::vector<const char*> extensions = EXTENSIONS;
+
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+        nullptr,
+        true
+    };
+
+    if (timelineSemaphoreSupport)
+    {
+        extensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+    }
+
+    if (memoryBudgetSupport)
+    {
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
 	VkDeviceCreateInfo deviceCreateInfo{
 		VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-		nullptr,
+		timelineSemaphoreSupport ? &timelineFeatures : nullptr,
 		0,
 		uint32_t(queueCreateInfos.size()),
 		queueCreateInfos.data(),
 		uint32_t(layers.size()),
 		layers.data(),
-		uint32_t(EXTENSIONS.size()),
-		EXTENSIONS.data(),
+		uint32_t(extensions.size()),
+		extensions.data(),
 		&deviceFeatures
 	};
 
 	CALL_VK(vkCreateDevice(physicalDevice, &deviceCreateInfo, nullptr, &device));
 	LOGI("Device created.");
+    LOGD("Queue families: graphics %d, compute %d, transfer %d, presentation %d.",
+        queueFamilyIndices.getGraphics(),
+        queueFamilyIndices.getCompute(),
+        queueFamilyIndices.getTransfer(),
+        queueFamilyIndices.getPresentation());
 
 	// save queue handlers
 	vkGetDeviceQueue(device, queueFamilyIndices.getGraphics(), 0, &graphicsQueue);
     vkGetDeviceQueue(device, queueFamilyIndices.getCompute(), 0, &computeQueue);
+    vkGetDeviceQueue(device, queueFamilyIndices.getTransfer(), 0, &transferQueue);
 	vkGetDeviceQueue(device, queueFamilyIndices.getPresentation(), 0, &presentQueue);
+
+    if (timelineSemaphoreSupport)
+    {
+        vkWaitSemaphoresKHR = PFN_vkWaitSemaphoresKHR(vkGetDeviceProcAddr(device, "vkWaitSemaphoresKHR"));
+        vkGetSemaphoreCounterValueKHR = PFN_vkGetSemaphoreCounterValueKHR(
+            vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValueKHR"));
+    }
 }
 
-void Device::createCommandPool()
+VkCommandPool Device::createCommandPool(uint32_t queueFamilyIndex) const
 {
 	VkCommandPoolCreateInfo createInfo{
 		VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
 		nullptr,
 		0,
-		getQueueFamilyIndices().getGraphics()
+		queueFamilyIndex
 	};
 
-	CALL_VK(vkCreateCommandPool(device, &createInfo, nullptr, &commandPool));
+	VkCommandPool pool;
+	CALL_VK(vkCreateCommandPool(device, &createInfo, nullptr, &pool));
+
+	return pool;
+}
+
+void Device::logMemoryTypes() const
+{
+    VkPhysicalDeviceMemoryProperties memProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+    for (uint32_t i = 0; i < memProperties.memoryHeapCount; i++)
+    {
+        LOGD("Memory heap %d: %llu MB, flags: %d.",
+            i,
+            static_cast<unsigned long long>(memProperties.memoryHeaps[i].size / (1024 * 1024)),
+            memProperties.memoryHeaps[i].flags);
+    }
+
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+    {
+        LOGD("Memory type %d: heap %d, flags: %d.",
+            i,
+            memProperties.memoryTypes[i].heapIndex,
+            memProperties.memoryTypes[i].propertyFlags);
+    }
 }
@@ -2,6 +2,10 @@
 #include "QueueFamilyIndices.h"
 #include "SurfaceSupportDetails.h"
 
+class UploadContext;
+class StagingRing;
+class MemoryAllocator;
+
 class Device
 {
 public:
@@ -15,16 +19,39 @@ public:
 
     VkQueue getComputeQueue() const;
 
+    VkQueue getTransferQueue() const;
+
 	VkQueue getPresentQueue() const;
 
+	// command pool of graphics queue family
 	VkCommandPool getCommandPool() const;
 
+    VkCommandPool getComputeCommandPool() const;
+
+    VkCommandPool getTransferCommandPool() const;
+
 	VkFormatProperties getFormatProperties(VkFormat format) const;
 
+    // extent of tile of partially resident 2D image (standard block shape), zero - format isn't supported
+    VkExtent3D getSparseImageGranularity(VkFormat format, VkImageUsageFlags usage) const;
+
+    // granularity of image copies of transfer queue, zero - only whole mip levels can be copied
+    VkExtent3D getTransferImageGranularity() const;
+
     void updateSurface(VkSurfaceKHR surface);
 
-	// returns index of memory type with such properties (for this physical device)
-	uint32_t findMemoryTypeIndex(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+	// returns index of memory type with such properties (for this physical device),
+	// type which also has preferred properties is chosen when it exists
+	uint32_t findMemoryTypeIndex(
+		uint32_t typeFilter,
+		VkMemoryPropertyFlags properties,
+		VkMemoryPropertyFlags preferredProperties = 0) const;
+
+	bool hasMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+	// memory is both device local and host visible (integrated GPUs),
+	// buffers can be written directly without staging
+	bool unifiedMemoryEnabled() const;
 
 	// returns first supported format (for this physical device)
 	VkFormat findSupportedFormat(
@@ -38,10 +65,45 @@ public:
 
     VkSampleCountFlagBits getMaxSampleCount() const;
 
+    VkPhysicalDeviceLimits getLimits() const;
+
+    VkPhysicalDeviceMemoryProperties getMemoryProperties() const;
+
+    // VK_KHR_timeline_semaphore is supported and enabled
+    bool timelineSemaphoresEnabled() const;
+
+    // blocks until timeline semaphore reaches the value
+    void waitSemaphore(VkSemaphore semaphore, uint64_t value) const;
+
+    uint64_t getSemaphoreValue(VkSemaphore semaphore) const;
+
+    // VK_EXT_memory_budget is supported and enabled
+    bool memoryBudgetEnabled() const;
+
+    // current usage and budget of each memory heap for this process
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT getMemoryBudget() const;
+
+    // partially resident 2D images are supported and enabled, non-resident texels are read as zeros,
+    // sparse memory is bound by graphics queue (see vkQueueBindSparse)
+    bool sparseResidencyEnabled() const;
+
+	// while upload context is set, one time commands are recorded into its command buffer
+	// and submitted by its flush, nullptr - one time commands are submitted immediately
+	void setUploadContext(UploadContext *context);
+
+	UploadContext* getUploadContext() const;
+
+	// sub-allocates memory of all images and buffers of device
+	MemoryAllocator* getMemoryAllocator() const;
+
+	// staging memory shared by uploads to device local buffers
+	StagingRing* getStagingRing() const;
+
 	// returns command buffer to write one time commands
 	VkCommandBuffer beginOneTimeCommands() const;
 
-	// ends command buffer and submit it to graphics queue
+	// ends command buffer, submits it to graphics queue and waits for completion
+	// (does nothing when upload context is set)
 	void endOneTimeCommands(VkCommandBuffer commandBuffer) const;
 
 private:
@@ -49,6 +111,8 @@ private:
 		VK_KHR_SWAPCHAIN_EXTENSION_NAME
 	};
 
+	const VkDeviceSize STAGING_RING_SIZE = 256 * 1024;
+
 	VkDevice device;
 
 	VkPhysicalDevice physicalDevice{};
@@ -59,10 +123,37 @@ private:
 
     VkQueue computeQueue;
 
+    VkQueue transferQueue;
+
 	VkQueue presentQueue;
 
 	VkCommandPool commandPool;
 
+    VkCommandPool computeCommandPool;
+
+    VkCommandPool transferCommandPool;
+
+    bool timelineSemaphoreSupport = false;
+
+    bool unifiedMemorySupport = false;
+
+    bool memoryBudgetSupport = false;
+
+    bool sparseResidencySupport = false;
+
+    UploadContext *uploadContext = nullptr;
+
+    MemoryAllocator *memoryAllocator;
+
+    StagingRing *stagingRing;
+
+    // functions from extensions (KHR) must be obtained before use
+    PFN_vkWaitSemaphoresKHR vkWaitSemaphoresKHR = nullptr;
+
+    PFN_vkGetSemaphoreCounterValueKHR vkGetSemaphoreCounterValueKHR = nullptr;
+
+    PFN_vkGetPhysicalDeviceMemoryProperties2KHR vkGetPhysicalDeviceMemoryProperties2KHR = nullptr;
+
 	void pickPhysicalDevice(VkInstance instance, const std::vector<const char*> &layers);
 
 	bool physicalDeviceSuitable(
@@ -74,7 +165,13 @@ private:
 
 	static bool checkDeviceExtensionSupport(VkPhysicalDevice device, const std::vector<const char*> &requiredExtensions);
 
+    bool checkTimelineSemaphoreSupport(VkInstance instance) const;
+
+    bool checkMemoryBudgetSupport(VkInstance instance);
+
+    void logMemoryTypes() const;
+
 	void createDevice(const std::vector<const char*> &layers);
 
-	void createCommandPool();
+	VkCommandPool createCommandPool(uint32_t queueFamilyIndex) const;
 };
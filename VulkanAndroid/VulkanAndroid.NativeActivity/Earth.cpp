@@ -1,20 +1,85 @@
 #include "Earth.h"
 #include <glm/ext/matrix_transform.inl>
+#include <glm/gtc/constants.hpp>
 #include "utils.h"
 #include "ActivityManager.h"
 #include "sphere.h"
+#include <algorithm>
+#include <array>
 
-Earth::Earth(Device *device, const std::string &texturePath) : Model(device), textures(EARTH_TEXTURE_TYPE_COUNT)
+Earth::Earth(
+    Device *device,
+    TextureLoader *textureLoader,
+    TextureStreamer *textureStreamer,
+    RingBuffer *uniformBuffer,
+    const std::string &texturePath)
+    : Model(uniformBuffer), textures(EARTH_TEXTURE_TYPE_COUNT)
 {
+    residentLodMap = new TextureImage(
+        device,
+        0,
+        VK_FORMAT_R8_UNORM,
+        { 1, 1, 1 },
+        1,
+        1,
+        VK_SAMPLE_COUNT_1_BIT,
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        false);
+    const uint8_t residentLevel = 0;
+    residentLodMap->updateData({ &residentLevel }, 0, sizeof(residentLevel));
+    residentLodMap->transitLayout(
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        {
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,
+            1,
+            0,
+            1
+        });
+    residentLodMap->pushFullView(VK_IMAGE_ASPECT_COLOR_BIT);
+    residentLodMap->pushSampler(VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+
     for (uint32_t i = 0; i < textures.size(); i++)
     {
-        textures[i] = new TextureImage(
-            device,
-            { ActivityManager::readAsset(texturePath + TEXTURE_FILES[i]) },
+        // virtual texture has the same layout all the time, tiles are bound to its memory on demand
+        const std::string virtualPath = file::replaceExtension(VIRTUAL_TEXTURE_PATH + TEXTURE_FILES[i], ".vtex");
+        VirtualTexture *virtualTexture = textureStreamer->loadVirtual(virtualPath, VIRTUAL_TEXTURE_CACHE_SIZE);
+        if (virtualTexture)
+        {
+            virtualTexture->pushSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+            virtualTextures.push_back(virtualTexture);
+            textures[i] = virtualTexture;
+            continue;
+        }
+
+        // compressed or KTX 2.0 version of texture with pre-generated mip levels is preferred
+        const std::string path = TextureImage::findAsset(device, texturePath + TEXTURE_FILES[i]);
+
+        // only mip tail is loaded before the first frame, streamed texture has its own view
+        StreamingTexture *streamingTexture = textureStreamer->load(path, false);
+        if (streamingTexture)
+        {
+            streamingTexture->pushSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+            textures[i] = streamingTexture;
+            continue;
+        }
+
+        // shader reconstructs z of normal from x and y, so normal map has two channels
+        textureLoader->load(
+            path,
+            { [path]() { return ActivityManager::openAsset(path); } },
+            i == EARTH_TEXTURE_TYPE_NORMAL ? STBI_grey_alpha : STBI_rgb_alpha,
             true,
-            false);
-        textures[i]->pushFullView(VK_IMAGE_ASPECT_COLOR_BIT);
-        textures[i]->pushSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+            false,
+            [this, i](TextureImage *texture)
+            {
+                texture->pushFullView(VK_IMAGE_ASPECT_COLOR_BIT);
+                texture->pushSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+                textures[i] = texture;
+            });
     }
 }
 
@@ -24,18 +89,29 @@ Earth::~Earth()
     {
         delete texture;
     }
+
+    delete residentLodMap;
 }
 
 std::vector<DescriptorInfo> Earth::getTextureInfos() const
 {
     std::vector<DescriptorInfo> result;
-    result.reserve(textures.size());
+    result.reserve(2 * textures.size());
 
     for (const auto &texture : textures)
     {
         result.push_back(texture->getCombineSamplerInfo());
     }
 
+    // LOD maps are bound after textures in the same order
+    for (const auto &texture : textures)
+    {
+        const auto virtualTexture = std::find(virtualTextures.begin(), virtualTextures.end(), texture);
+        result.push_back(virtualTexture != virtualTextures.end()
+            ? (*virtualTexture)->getLodMapInfo()
+            : residentLodMap->getCombineSamplerInfo());
+    }
+
     return result;
 }
 
@@ -59,3 +135,104 @@ void Earth::rotate(float angle)
     this->angle += angle;
     setTransformation(glm::rotate(getTransformation(), glm::radians(angle), -axis::Y));
 }
+
+void Earth::requestTiles(glm::vec3 cameraPosition, float pixelAngle)
+{
+    if (virtualTextures.empty())
+    {
+        return;
+    }
+
+    const glm::vec3 camera = glm::vec3(glm::inverse(getTransformation()) * glm::vec4(cameraPosition, 1.0f));
+    const float pi = glm::pi<float>();
+
+    // texture coordinates of sphere (see sphere::VERTICES)
+    const auto getDirection = [pi](glm::vec2 uv)
+    {
+        const float latitude = (uv.y - 0.5f) * pi;
+        const float longitude = (uv.x - 0.25f) * 2.0f * pi;
+
+        return glm::vec3(
+            -std::sin(longitude) * std::cos(latitude),
+            std::sin(latitude),
+            -std::cos(longitude) * std::cos(latitude));
+    };
+
+    const glm::vec3 cameraDirection = glm::normalize(camera);
+    const float cameraLatitude = std::asin(glm::clamp(cameraDirection.y, -1.0f, 1.0f));
+    float cameraU = std::atan2(-cameraDirection.x, -cameraDirection.z) / (2.0f * pi) + 0.25f;
+    cameraU -= std::floor(cameraU);
+
+    // point of tile which is the nearest to the camera, it's visible if any point of tile is above horizon
+    const auto getNearestUv = [&](glm::vec2 uvBegin, glm::vec2 uvEnd)
+    {
+        // the nearest meridian of tile (longitude wraps around)
+        const auto getDistance = [](float a, float b)
+        {
+            const float distance = glm::abs(a - b);
+            return (std::min)(distance, 1.0f - distance);
+        };
+        const bool insideU = cameraU >= uvBegin.x && cameraU <= uvEnd.x;
+        const float u = insideU
+            ? cameraU
+            : getDistance(cameraU, uvBegin.x) < getDistance(cameraU, uvEnd.x) ? uvBegin.x : uvEnd.x;
+
+        // cosine of angle to camera along the meridian is A * cos(latitude - peakLatitude)
+        const float longitudeDelta = getDistance(cameraU, u) * 2.0f * pi;
+        const float peakLatitude = std::atan2(
+            std::sin(cameraLatitude),
+            std::cos(cameraLatitude) * std::cos(longitudeDelta));
+        const auto getCosine = [&](float v)
+        {
+            return std::cos((v - 0.5f) * pi - peakLatitude);
+        };
+
+        const float peakV = peakLatitude / pi + 0.5f;
+        const float v = peakV >= uvBegin.y && peakV <= uvEnd.y
+            ? peakV
+            : getCosine(uvBegin.y) > getCosine(uvEnd.y) ? uvBegin.y : uvEnd.y;
+
+        return glm::vec2(u, v);
+    };
+
+    // the smallest footprint of visible samples (corners, middles of edges, center and the nearest point),
+    // the nearest point doesn't underestimate large tiles and tiles partially visible at the limb
+    const auto getFootprint = [&](glm::vec2 uvBegin, glm::vec2 uvEnd)
+    {
+        std::array<glm::vec2, 10> samples;
+        for (uint32_t y = 0; y <= 2; y++)
+        {
+            for (uint32_t x = 0; x <= 2; x++)
+            {
+                samples[y * 3 + x] = glm::mix(uvBegin, uvEnd, glm::vec2(x, y) * 0.5f);
+            }
+        }
+        samples[9] = getNearestUv(uvBegin, uvEnd);
+
+        Optional<glm::vec2> result{ glm::vec2((std::numeric_limits<float>::max)()), false };
+        for (const auto &uv : samples)
+        {
+            const glm::vec3 direction = getDirection(uv);
+            const glm::vec3 toCamera = camera - sphere::R * direction;
+            if (glm::dot(direction, toCamera) <= 0.0f)
+            {
+                continue;
+            }
+
+            // parallels are shorter near the poles, foreshortening is ignored
+            const float pixelSize = glm::length(toCamera) * pixelAngle;
+            const float parallel = 2.0f * pi * sphere::R * (std::max)(std::cos((uv.y - 0.5f) * pi), 0.01f);
+            const float meridian = pi * sphere::R;
+
+            result.first = glm::min(result.first, glm::vec2(pixelSize / parallel, pixelSize / meridian));
+            result.second = true;
+        }
+
+        return result;
+    };
+
+    for (auto texture : virtualTextures)
+    {
+        texture->requestTiles(getFootprint);
+    }
+}
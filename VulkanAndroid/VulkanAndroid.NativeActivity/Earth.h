@@ -1,6 +1,7 @@
 #pragma once
 #include "Model.h"
-#include "TextureImage.h"
+#include "TextureLoader.h"
+#include "TextureStreamer.h"
 
 enum EarthTextureType
 {
@@ -14,7 +15,14 @@ class Earth :
     public Model
 {
 public:
-    Earth(Device *device, const std::string &texturePath);
+    // tiled textures of high resolution are virtual (if device supports it),
+    // KTX 2.0 textures with mip levels are streamed, others are created by loader after decoding
+    Earth(
+        Device *device,
+        TextureLoader *textureLoader,
+        TextureStreamer *textureStreamer,
+        RingBuffer *uniformBuffer,
+        const std::string &texturePath);
 
     virtual ~Earth();
 
@@ -28,13 +36,30 @@ public:
 
     void rotate(float angle);
 
+    // requests tiles of virtual textures which are visible from the camera,
+    // footprints are computed from sphere mapping instead of GPU feedback pass:
+    // requests aren't late by readback of previous frames and fragment shader doesn't write extra target,
+    // pixelAngle - angle between rays of adjacent pixels (see Camera::getPixelAngle)
+    void requestTiles(glm::vec3 cameraPosition, float pixelAngle);
+
 private:
     const std::vector<std::string> TEXTURE_FILES{
         "Day.jpg", "Night.jpg", "Normal.jpg"
     };
 
+    const std::string VIRTUAL_TEXTURE_PATH = "textures/earth/virtual/";
+
+    // 512 tiles of 128x128 RGBA - 32 MB per texture regardless of its resolution
+    const uint32_t VIRTUAL_TEXTURE_CACHE_SIZE = 512;
+
     std::vector<TextureImage*> textures;
 
+    // subset of textures
+    std::vector<VirtualTexture*> virtualTextures;
+
+    // LOD map of textures which aren't virtual (zero level everywhere, see VirtualTexture::getLodMapInfo)
+    TextureImage *residentLodMap;
+
     float angle{};
 };
 
@@ -1,7 +1,11 @@
 #include "EarthRenderPass.h"
 
-EarthRenderPass::EarthRenderPass(Device *device, VkExtent2D attachmentExtent, VkSampleCountFlagBits sampleCount)
-    : RenderPass(device, attachmentExtent, sampleCount)
+EarthRenderPass::EarthRenderPass(
+    Device *device,
+    VkExtent2D attachmentExtent,
+    VkSampleCountFlagBits sampleCount,
+    uint32_t frameCount)
+    : RenderPass(device, attachmentExtent, sampleCount), frameCount(frameCount)
 {
     
 }
@@ -22,15 +26,13 @@ std::vector<VkClearValue> EarthRenderPass::getClearValues() const
     return { colorClearValue, depthClearValue };
 }
 
-TextureImage* EarthRenderPass::getColorTexture() const
+TextureImage* EarthRenderPass::getColorTexture(uint32_t frameIndex) const
 {
-    return colorTexture.get();
+    return colorTextures[frameIndex].get();
 }
 
 void EarthRenderPass::createAttachments()
 {
-    // Color attachment:
-
     const VkFormat colorImageFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
     const VkExtent3D attachmentExtent{
         extent.width,
@@ -38,91 +40,93 @@ void EarthRenderPass::createAttachments()
         1
     };
 
-
     LOGA(device->getFormatProperties(colorImageFormat).optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT);
 
-    colorTexture = std::make_shared<TextureImage>(
-        device,
-        0,
-        colorImageFormat,
-        attachmentExtent,
-        Image::calculateMipLevelCount(attachmentExtent),
-        1,
-        sampleCount,
-        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
-        false);
-    colorTexture->pushView(
-        VK_IMAGE_VIEW_TYPE_2D,
-        {
-            VK_IMAGE_ASPECT_COLOR_BIT,
-            0, 
-            1, 
-            0, 
-            1
-        });
-    colorTexture->pushView(
-        VK_IMAGE_VIEW_TYPE_2D,
-        {
-            VK_IMAGE_ASPECT_COLOR_BIT,
-            colorTexture->getMipLevelCount() - 1,
-            1,
-            0,
-            1
-        });
-    colorTexture->pushSampler(VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER);
+    colorTextures.clear();
+    depthImages.clear();
+    attachments.clear();
 
-    colorTexture->transitLayout(
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-        {
-            VK_IMAGE_ASPECT_COLOR_BIT,
+    // frames in flight render to their own attachments,
+    // so computing of one frame doesn't block rendering of the next frame
+    for (uint32_t i = 0; i < frameCount; i++)
+    {
+        // Color attachment:
+
+        const auto colorTexture = std::make_shared<TextureImage>(
+            device,
             0,
+            colorImageFormat,
+            attachmentExtent,
+            Image::calculateMipLevelCount(attachmentExtent),
             1,
+            sampleCount,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+            false);
+        colorTexture->pushView(
+            VK_IMAGE_VIEW_TYPE_2D,
+            {
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                0, 
+                1, 
+                0, 
+                1
+            });
+        colorTexture->pushView(
+            VK_IMAGE_VIEW_TYPE_2D,
+            {
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                colorTexture->getMipLevelCount() - 1,
+                1,
+                0,
+                1
+            });
+        colorTexture->pushSampler(VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER);
+
+        colorTexture->transitLayout(
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            {
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                0,
+                1,
+                0,
+                1
+            });
+        colorTexture->transitLayout(
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            {
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                1,
+                colorTexture->getMipLevelCount() - 1,
+                0,
+                1
+            });
+
+        // Depth attachment:
+
+        // depth is used only inside of render pass, so it can stay in tile memory
+        const auto depthImage = std::make_shared<Image>(
+            device,
             0,
-            1
-        });
-    colorTexture->transitLayout(
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        {
-            VK_IMAGE_ASPECT_COLOR_BIT,
+            depthAttachmentFormat,
+            attachmentExtent,
             1,
-            colorTexture->getMipLevelCount() - 1,
-            0,
-            1
-        });
-
-    // Depth attachment:
-
-    depthImage = std::make_shared<Image>(
-        device,
-        0,
-        depthAttachmentFormat,
-        attachmentExtent,
-        1,
-        1,
-        sampleCount,
-        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-        false);
-    depthImage->pushFullView(VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
-    depthImage->transitLayout(
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
-        {
-            VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT,
-            0,
             1,
-            0,
-            1
-        });
+            sampleCount,
+            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+            false);
+        depthImage->pushFullView(VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
 
-	attachments = { colorTexture, depthImage };
+        colorTextures.push_back(colorTexture);
+        depthImages.push_back(depthImage);
+        attachments.push_back(colorTexture);
+        attachments.push_back(depthImage);
+    }
 }
 
 void EarthRenderPass::createRenderPass()
@@ -131,25 +135,27 @@ void EarthRenderPass::createRenderPass()
 
     const VkAttachmentDescription colorAttachmentDesc{
 		0,								
-        colorTexture->getFormat(),
-        colorTexture->getSampleCount(),
+        colorTextures.front()->getFormat(),
+        colorTextures.front()->getSampleCount(),
         VK_ATTACHMENT_LOAD_OP_DONT_CARE,
 		VK_ATTACHMENT_STORE_OP_STORE,		     
 		VK_ATTACHMENT_LOAD_OP_DONT_CARE,	     
 		VK_ATTACHMENT_STORE_OP_DONT_CARE,	     
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        // previous content is not loaded, so it isn't returned from computing queue
+        VK_IMAGE_LAYOUT_UNDEFINED,
         VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
 	};
 
     const VkAttachmentDescription depthAttachmentDesc{
 		0,										
-		depthImage->getFormat(),						
-		depthImage->getSampleCount(),					
+		depthImages.front()->getFormat(),
+		depthImages.front()->getSampleCount(),					
 		VK_ATTACHMENT_LOAD_OP_CLEAR,						 
 		VK_ATTACHMENT_STORE_OP_DONT_CARE,				
 		VK_ATTACHMENT_LOAD_OP_DONT_CARE,
 		VK_ATTACHMENT_STORE_OP_DONT_CARE,				
-		VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        // depth is cleared, so layout is changed by render pass without separate transition
+        VK_IMAGE_LAYOUT_UNDEFINED,
 		VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
 	};
 
@@ -196,6 +202,18 @@ void EarthRenderPass::createRenderPass()
 		VK_DEPENDENCY_BY_REGION_BIT,                    
 	};
 
+    // depth of previous frame in this framebuffer is written before layout transition and clear
+    const VkSubpassDependency depthDependency{
+		VK_SUBPASS_EXTERNAL,
+		0,
+		VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+		VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+		VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+		VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+		VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+		VK_DEPENDENCY_BY_REGION_BIT,
+	};
+
     const VkSubpassDependency outputDependency{
 		0,									
 		VK_SUBPASS_EXTERNAL,							
@@ -209,6 +227,7 @@ void EarthRenderPass::createRenderPass()
 
 	std::vector<VkSubpassDependency> dependencies{
 		inputDependency,
+		depthDependency,
 		outputDependency
 	};
 
@@ -232,5 +251,8 @@ void EarthRenderPass::createRenderPass()
 
 void EarthRenderPass::createFramebuffers()
 {
-    addFramebuffer({ colorTexture->getView(), depthImage->getView(), });
+    for (uint32_t i = 0; i < frameCount; i++)
+    {
+        addFramebuffer({ colorTextures[i]->getView(), depthImages[i]->getView(), });
+    }
 }
@@ -7,13 +7,14 @@
 class EarthRenderPass : public RenderPass
 {
 public:
-	EarthRenderPass(Device *device, VkExtent2D attachmentExtent, VkSampleCountFlagBits sampleCount);
+	// frameCount - number of attachment sets (and framebuffers), one for each frame in flight
+	EarthRenderPass(Device *device, VkExtent2D attachmentExtent, VkSampleCountFlagBits sampleCount, uint32_t frameCount);
 
     uint32_t getColorAttachmentCount() const override;
 
     std::vector<VkClearValue> getClearValues() const override;
 
-    TextureImage* getColorTexture() const;
+    TextureImage* getColorTexture(uint32_t frameIndex) const;
 
 protected:
     void createAttachments() override;
@@ -23,8 +24,10 @@ protected:
 	void createFramebuffers() override;
 
 private:
-	std::shared_ptr<TextureImage> colorTexture;
+	uint32_t frameCount;
 
-	std::shared_ptr<Image> depthImage;
+	std::vector<std::shared_ptr<TextureImage>> colorTextures;
+
+	std::vector<std::shared_ptr<Image>> depthImages;
 };
 
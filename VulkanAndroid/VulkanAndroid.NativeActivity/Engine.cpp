@@ -5,9 +5,16 @@
 #include "GraphicsPipeline.h"
 #include "ComputePipeline.h"
 #include "PositionUv.h"
+#include "UploadContext.h"
+#include "StagingRing.h"
+#include "MemoryAllocator.h"
+#include "ActivityManager.h"
 
-Engine::Engine() : created(false), outdated(false)
+Engine::Engine(uint32_t frameCount, SwapChain::Policy swapChainPolicy, float idleFps)
+    : created(false), outdated(false), frameCount(frameCount), swapChainPolicy(swapChainPolicy), idleFps(idleFps)
 {
+    LOGA(frameCount > 0 && frameCount <= MAX_FRAME_COUNT);
+
 	InitVulkan();
 
 	instance = new Instance();
@@ -26,39 +33,74 @@ bool Engine::create(ANativeWindow *window)
 
     surface = new Surface(instance->get(), window);
     device = new Device(instance->get(), surface->get(), instance->getLayers());
-    swapChain = new SwapChain(device, surface->get(), window::getExtent(window));
-    scene = new Scene(device, swapChain->getExtent());
 
-    earthRenderPass = new EarthRenderPass(device, swapChain->getExtent(), VK_SAMPLE_COUNT_1_BIT);
+    // all uploads and layout transitions of loading are submitted at once
+    Timer loadingTimer;
+    loadingTimer.getDeltaSec();
+    UploadContext uploadContext(device);
+    device->setUploadContext(&uploadContext);
+
+    swapChain = new SwapChain(device, surface->get(), window::getExtent(window), swapChainPolicy);
+    scene = new Scene(device, swapChain->getExtent(), frameCount, idleFps);
+
+    earthRenderPass = new EarthRenderPass(device, swapChain->getExtent(), VK_SAMPLE_COUNT_1_BIT, frameCount);
     galleryRenderPass = new GalleryRenderPass(device, swapChain, VK_SAMPLE_COUNT_1_BIT);
     earthRenderPass->create();
     galleryRenderPass->create();
 
+    // earth and clouds have set for each frame, so streamed textures are rebound without waiting for other frames
     descriptorPool = new DescriptorPool(
         device,
         {
-            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, Scene::TEXTURE_COUNT + 2 },
+            {
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                Scene::TEXTURE_COUNT + 2 * frameCount + (Scene::EARTH_TEXTURE_COUNT + 1) * (frameCount - 1)
+            },
             { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, swapChain->getImageCount() + 1 },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, Scene::BUFFER_COUNT + 0 }
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, Scene::DYNAMIC_BUFFER_COUNT + 2 * (frameCount - 1) }
         },
-        DESCRIPTOR_TYPE_COUNT + 1 + swapChain->getImageCount());
+        DESCRIPTOR_TYPE_COUNT + 1 + 4 * (frameCount - 1) + swapChain->getImageCount());
 
     createLuminosityImage();
 
+    uploadContext.flush();
+    device->setUploadContext(nullptr);
+
+    LOGI("Resources loaded: %.3f s, %d one time command sequences in %d submissions, staging peak %.1f MB.",
+        loadingTimer.getDeltaSec(),
+        uploadContext.getBatchedCount(),
+        uploadContext.getFlushCount(),
+        float(uploadContext.getPeakStagingSize()) / (1024.0f * 1024.0f));
+
+    device->getMemoryAllocator()->logStats();
+
     initDescriptorSets();
     initLocalGroupSize();
     initPipelines();
 
-    earthRenderingFinished = createSemaphore();
-    computingFinished = createSemaphore();
-    galleryRenderingFinished = createSemaphore();
-    imageAvailable = createSemaphore();
+    // new timeline semaphores start from zero
+    frameNumber = 0;
+    publishCount = 0;
+
+    timelineEnabled = device->timelineSemaphoresEnabled();
+    if (timelineEnabled)
+    {
+        timelines.resize(TIMELINE_TYPE_COUNT);
+        for (auto &timeline : timelines)
+        {
+            timeline = new TimelineSemaphore(device);
+        }
+    }
+
+    createFrames();
 
     initEarthRenderingCommands(); 
     initComputingCommands();
     initGalleryRenderingCommands();
 
     LOGI("Engine created.");
+    LOGI("Frames in flight: %d.", frameCount);
+    LOGI("Frame synchronization: %s.", timelineEnabled ? "timeline semaphores" : "binary semaphores and fences");
 
     return created = true;
 }
@@ -87,6 +129,9 @@ bool Engine::recreate(ANativeWindow *window)
 
         updateChangedDescriptorSets();
 
+        imageFences.assign(swapChain->getImageCount(), VK_NULL_HANDLE);
+        imageFrameNumbers.assign(swapChain->getImageCount(), 0);
+
         initEarthRenderingCommands();
         initComputingCommands();
         initGalleryRenderingCommands();
@@ -111,6 +156,7 @@ void Engine::unpause()
 {
     paused = false;
     scene->skipTime();
+    scene->invalidate();
 }
 
 bool Engine::onPause()
@@ -133,11 +179,80 @@ void Engine::activateGallery()
     scene->activateGallery();
 }
 
+uint32_t Engine::getFrameSubmitCount() const
+{
+    return submitter.getFrameSubmitCount();
+}
+
+uint64_t Engine::getSkippedFrameCount() const
+{
+    return skippedFrameCount;
+}
+
+std::string Engine::getMemoryReport() const
+{
+    if (!created)
+    {
+        return std::string();
+    }
+
+    std::string report = device->getMemoryAllocator()->getReport();
+
+    // idle scene doesn't draw frames, so it doesn't use bandwidth of memory
+    report += "Skipped frames: " + std::to_string(getSkippedFrameCount()) + "\n";
+    report += "Queue submits of the last frame: " + std::to_string(getFrameSubmitCount()) + "\n";
+
+    return report;
+}
+
+void Engine::dumpMemoryReport() const
+{
+    if (!created)
+    {
+        return;
+    }
+
+    device->getMemoryAllocator()->logStats();
+    LOGI("Skipped frames: %llu.", static_cast<unsigned long long>(getSkippedFrameCount()));
+    LOGI("Queue submits of the last frame: %u.", getFrameSubmitCount());
+    ActivityManager::write(MEMORY_REPORT_FILE, getMemoryReport());
+}
+
 bool Engine::drawFrame()
 {
     if (!created || outdated || paused) return false;
 
-    scene->update();
+    // streaming continues while scene is static, published levels require redrawing
+    if (scene->updateTextures())
+    {
+        publishStreamedTextures();
+    }
+
+    // the last presented image is still actual
+    if (!scene->isRedrawRequired())
+    {
+        skippedFrameCount++;
+        return false;
+    }
+
+    Frame &frame = frames[frameIndex];
+
+    // resources of this frame can be reused only when GPU finishes it
+    waitFrame(frame);
+
+    // descriptors of this frame aren't used anymore, so streamed textures are rebound
+    if (frame.publishCount != publishCount)
+    {
+        updateFrameTextures(frameIndex);
+    }
+
+    // frames are completed in order, so previous views aren't used by frames up to this one
+    scene->releaseTextureViews(frame.number);
+
+    // staging regions of completed uploads are recycled as frames complete
+    device->getStagingRing()->update();
+
+    scene->update(frameIndex);
 
     uint32_t imageIndex;
 
@@ -145,7 +260,7 @@ bool Engine::drawFrame()
         device->get(), 
         swapChain->get(), 
         UINT64_MAX, 
-        imageAvailable, 
+        frame.imageAvailable, 
         nullptr, 
         &imageIndex);
 
@@ -159,66 +274,38 @@ bool Engine::drawFrame()
         CALL_VK(result);
     }
 
-    // Earth rendering:
+    frame.number = ++frameNumber;
 
-    std::vector<VkSemaphore> earthRenderingSignalSemaphores{ earthRenderingFinished };
-    VkSubmitInfo renderingSubmitInfo{
-        VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        nullptr,
-        0,
-        nullptr,
-        nullptr,
-        1,
-        &earthRenderingCommands,
-        uint32_t(earthRenderingSignalSemaphores.size()),
-        earthRenderingSignalSemaphores.data(),
-    };
-    CALL_VK(vkQueueSubmit(device->getGraphicsQueue(), 1, &renderingSubmitInfo, nullptr));
+    // swapchain image can be still used by another frame
+    waitImage(imageIndex, frame);
 
-    // Computing:
+    const uint32_t commandsIndex = frameIndex * swapChain->getImageCount() + imageIndex;
 
-    std::vector<VkSemaphore> computingWaitSemaphores{ earthRenderingFinished, imageAvailable};
-    std::vector<VkPipelineStageFlags> computingWaitStages{ VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT };
-    std::vector<VkSemaphore> computingSignalSemaphores{ computingFinished };
-    VkSubmitInfo computingSubmitInfo{
-        VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        nullptr,
-        uint32_t(computingWaitSemaphores.size()),
-        computingWaitSemaphores.data(),
-        computingWaitStages.data(),
-        1,
-        &computingCommands[imageIndex],
-        uint32_t(computingSignalSemaphores.size()),
-        computingSignalSemaphores.data(),
-    };
-    CALL_VK(vkQueueSubmit(device->getComputeQueue(), 1, &computingSubmitInfo, nullptr));
+    submitter.begin();
 
-    // Gallery rendering:
+    if (timelineEnabled)
+    {
+        pushTimelineSubmissions(frame, commandsIndex);
+        submitter.flush(VK_NULL_HANDLE);
+    }
+    else
+    {
+        CALL_VK(vkResetFences(device->get(), 1, &frame.fence));
 
-    std::vector<VkSemaphore> galleryRenderingWaitSemaphores{ computingFinished };
-    std::vector<VkPipelineStageFlags> galleryWaitStages{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-    std::vector<VkSemaphore> gallerySignalSemaphores{ galleryRenderingFinished };
-    VkSubmitInfo gallerySubmitInfo{
-        VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        nullptr,
-        uint32_t(galleryRenderingWaitSemaphores.size()),
-        galleryRenderingWaitSemaphores.data(),
-        galleryWaitStages.data(),
-        1,
-        &galleryRenderingCommands[imageIndex],
-        uint32_t(gallerySignalSemaphores.size()),
-        gallerySignalSemaphores.data(),
-    };
-    CALL_VK(vkQueueSubmit(device->getComputeQueue(), 1, &gallerySubmitInfo, nullptr));
+        pushBinarySubmissions(frame, commandsIndex);
+        submitter.flush(frame.fence);
+    }
+
+    frameIndex = (frameIndex + 1) % frameCount;
 
-    std::vector<VkSwapchainKHR> swapChains{ swapChain->get() };
+    const VkSwapchainKHR swapChainHandle = swapChain->get();
     VkPresentInfoKHR presentInfo{
         VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
         nullptr,
-        uint32_t(gallerySignalSemaphores.size()),
-        gallerySignalSemaphores.data(),
-        uint32_t(swapChains.size()),
-        swapChains.data(),
+        1,
+        &frame.galleryRenderingFinished,
+        1,
+        &swapChainHandle,
         &imageIndex,
         nullptr,
     };
@@ -241,10 +328,13 @@ bool Engine::destroy()
 
     vkDeviceWaitIdle(device->get());
 
-    vkDestroySemaphore(device->get(), imageAvailable, nullptr);
-    vkDestroySemaphore(device->get(), galleryRenderingFinished, nullptr);
-    vkDestroySemaphore(device->get(), computingFinished, nullptr);
-    vkDestroySemaphore(device->get(), earthRenderingFinished, nullptr);
+    destroyFrames();
+
+    for (auto timeline : timelines)
+    {
+        delete timeline;
+    }
+    timelines.clear();
 
     for (auto pipeline : pipelines)
     {
@@ -280,16 +370,16 @@ void Engine::initDescriptorSets()
 
     descriptors[DESCRIPTOR_TYPE_SCENE] = new DescriptorSets(
         descriptorPool,
-        { { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, { VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT } } });
+        { { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, { VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT } } });
     descriptors[DESCRIPTOR_TYPE_SCENE]->pushDescriptorSet(
         {
             {
-                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                { scene->getCameraBuffer()->getUniformBufferInfo(), scene->getLightingBufferInfo() }
+                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                { scene->getCameraBufferInfo(), scene->getLightingBufferInfo() }
             }
         });
 
-    // Earth:
+    // Earth (set for each frame):
 
     std::vector<DescriptorInfo> earthTextureInfos = scene->getModelTextureInfos(Scene::ModelId::EARTH);
     descriptors[DESCRIPTOR_TYPE_EARTH] = new DescriptorSets(
@@ -299,36 +389,40 @@ void Engine::initDescriptorSets()
                 VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
                 std::vector<VkShaderStageFlags>(earthTextureInfos.size(), VK_SHADER_STAGE_FRAGMENT_BIT)
             },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, { VK_SHADER_STAGE_VERTEX_BIT } },
-        });
-    descriptors[DESCRIPTOR_TYPE_EARTH]->pushDescriptorSet(
-        {
-            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, earthTextureInfos },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, { scene->getModelTransformationBufferInfo(Scene::ModelId::EARTH) } }
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, { VK_SHADER_STAGE_VERTEX_BIT } },
         });
+    for (uint32_t i = 0; i < frameCount; i++)
+    {
+        descriptors[DESCRIPTOR_TYPE_EARTH]->pushDescriptorSet(
+            {
+                { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, earthTextureInfos },
+                { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, { scene->getModelTransformationBufferInfo(Scene::ModelId::EARTH) } }
+            });
+    }
 
-    // Clouds and skybox:
+    // Clouds (set for each frame) and skybox (the last set):
 
     descriptors[DESCRIPTOR_TYPE_CLOUDS_AND_SKYBOX] = new DescriptorSets(
         descriptorPool,
         {
             { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, { VK_SHADER_STAGE_FRAGMENT_BIT } },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, { VK_SHADER_STAGE_VERTEX_BIT } }
-        });
-    descriptors[DESCRIPTOR_TYPE_CLOUDS_AND_SKYBOX]->pushDescriptorSet(
-        {
-            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, scene->getModelTextureInfos(Scene::ModelId::CLOUDS) },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, { scene->getModelTransformationBufferInfo(Scene::ModelId::CLOUDS) } }
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, { VK_SHADER_STAGE_VERTEX_BIT } }
         });
+    for (uint32_t i = 0; i < frameCount; i++)
+    {
+        descriptors[DESCRIPTOR_TYPE_CLOUDS_AND_SKYBOX]->pushDescriptorSet(
+            {
+                { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, scene->getModelTextureInfos(Scene::ModelId::CLOUDS) },
+                { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, { scene->getModelTransformationBufferInfo(Scene::ModelId::CLOUDS) } }
+            });
+    }
     descriptors[DESCRIPTOR_TYPE_CLOUDS_AND_SKYBOX]->pushDescriptorSet(
         {
             { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, scene->getModelTextureInfos(Scene::ModelId::SKYBOX) },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, { scene->getModelTransformationBufferInfo(Scene::ModelId::SKYBOX) } }
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, { scene->getModelTransformationBufferInfo(Scene::ModelId::SKYBOX) } }
         });
 
-    // Luminosity:
-
-    const auto colorTexture = earthRenderPass->getColorTexture();
+    // Luminosity (source set for each frame):
 
     descriptors[DESCRIPTOR_TYPE_LUMINOSITY_SRC] = new DescriptorSets(
         descriptorPool,
@@ -338,13 +432,16 @@ void Engine::initDescriptorSets()
                 { VK_SHADER_STAGE_COMPUTE_BIT }
             }
         });
-    descriptors[DESCRIPTOR_TYPE_LUMINOSITY_SRC]->pushDescriptorSet(
-        {
+    for (uint32_t i = 0; i < frameCount; i++)
+    {
+        descriptors[DESCRIPTOR_TYPE_LUMINOSITY_SRC]->pushDescriptorSet(
             {
-                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                { colorTexture->getCombineSamplerInfo(0, 1) }
-            }
-        });
+                {
+                    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                    { earthRenderPass->getColorTexture(i)->getCombineSamplerInfo(0, 1) }
+                }
+            });
+    }
 
     descriptors[DESCRIPTOR_TYPE_LUMINOSITY_DST] = new DescriptorSets(
         descriptorPool,
@@ -362,7 +459,7 @@ void Engine::initDescriptorSets()
             }
         });
 
-    // Tone:
+    // Tone (source set for each frame):
 
     descriptors[DESCRIPTOR_TYPE_TONE_SRC] = new DescriptorSets(
         descriptorPool,
@@ -372,13 +469,16 @@ void Engine::initDescriptorSets()
                 { VK_SHADER_STAGE_COMPUTE_BIT }
             }
         });
-    descriptors[DESCRIPTOR_TYPE_TONE_SRC]->pushDescriptorSet(
-        {
+    for (uint32_t i = 0; i < frameCount; i++)
+    {
+        descriptors[DESCRIPTOR_TYPE_TONE_SRC]->pushDescriptorSet(
             {
-                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                { colorTexture->getCombineSamplerInfo() }
-            }
-        });
+                {
+                    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                    { earthRenderPass->getColorTexture(i)->getCombineSamplerInfo() }
+                }
+            });
+    }
 
     descriptors[DESCRIPTOR_TYPE_TONE_DST] = new DescriptorSets(
         descriptorPool,
@@ -395,13 +495,13 @@ void Engine::initDescriptorSets()
         descriptorPool,
         {
             { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, { VK_SHADER_STAGE_FRAGMENT_BIT } },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, { VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT } }
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, { VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT } }
         });
     descriptors[DESCRIPTOR_TYPE_GALLERY]->pushDescriptorSet(
         {
             { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, scene->getModelTextureInfos(Scene::ModelId::GALLERY) },
             {
-                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                 {
                     scene->getModelTransformationBufferInfo(Scene::ModelId::GALLERY),
                     scene->getModelUniformBufferInfo(Scene::ModelId::GALLERY)[0]
@@ -585,6 +685,20 @@ void Engine::createLuminosityImage()
     };
 
     luminosityImage->updateData({ defaultLuminosity.data() }, 0, defaultLuminosity.size() * sizeof(hdata));
+
+    // luminosity is rewritten by computing queue every frame, so its ownership isn't transferred
+    luminosityImage->transitLayout(
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_IMAGE_LAYOUT_GENERAL,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        {
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,
+            1,
+            0,
+            1
+        });
 }
 
 VkSemaphore Engine::createSemaphore() const
@@ -602,13 +716,158 @@ VkSemaphore Engine::createSemaphore() const
     return semaphore;
 }
 
+VkFence Engine::createFence() const
+{
+    VkFence fence;
+
+    // signaled fence doesn't block the first use of frame
+    VkFenceCreateInfo createInfo{
+        VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+        nullptr,
+        VK_FENCE_CREATE_SIGNALED_BIT,
+    };
+
+    CALL_VK(vkCreateFence(device->get(), &createInfo, nullptr, &fence));
+
+    return fence;
+}
+
+void Engine::createFrames()
+{
+    frames.resize(frameCount);
+
+    for (auto &frame : frames)
+    {
+        frame.imageAvailable = createSemaphore();
+        frame.galleryRenderingFinished = createSemaphore();
+        frame.earthRenderingFinished = timelineEnabled ? VK_NULL_HANDLE : createSemaphore();
+        frame.computingFinished = timelineEnabled ? VK_NULL_HANDLE : createSemaphore();
+        frame.fence = timelineEnabled ? VK_NULL_HANDLE : createFence();
+        frame.number = 0;
+        frame.publishCount = publishCount;
+        frame.earthRenderingCommands = VK_NULL_HANDLE;
+    }
+
+    frameIndex = 0;
+    imageFences.assign(swapChain->getImageCount(), VK_NULL_HANDLE);
+    imageFrameNumbers.assign(swapChain->getImageCount(), 0);
+}
+
+void Engine::destroyFrames()
+{
+    for (auto &frame : frames)
+    {
+        vkFreeCommandBuffers(device->get(), device->getCommandPool(), 1, &frame.earthRenderingCommands);
+        vkDestroyFence(device->get(), frame.fence, nullptr);
+        vkDestroySemaphore(device->get(), frame.computingFinished, nullptr);
+        vkDestroySemaphore(device->get(), frame.earthRenderingFinished, nullptr);
+        vkDestroySemaphore(device->get(), frame.galleryRenderingFinished, nullptr);
+        vkDestroySemaphore(device->get(), frame.imageAvailable, nullptr);
+    }
+
+    frames.clear();
+    imageFences.clear();
+    imageFrameNumbers.clear();
+}
+
+void Engine::waitFrame(const Frame &frame) const
+{
+    if (timelineEnabled)
+    {
+        // gallery is the last pass, it is signaled after all other passes of frame
+        timelines[TIMELINE_TYPE_GALLERY]->wait(frame.number);
+    }
+    else
+    {
+        CALL_VK(vkWaitForFences(device->get(), 1, &frame.fence, true, UINT64_MAX));
+    }
+}
+
+void Engine::waitImage(uint32_t imageIndex, const Frame &frame)
+{
+    if (timelineEnabled)
+    {
+        timelines[TIMELINE_TYPE_GALLERY]->wait(imageFrameNumbers[imageIndex]);
+        imageFrameNumbers[imageIndex] = frame.number;
+    }
+    else
+    {
+        if (imageFences[imageIndex])
+        {
+            CALL_VK(vkWaitForFences(device->get(), 1, &imageFences[imageIndex], true, UINT64_MAX));
+        }
+        imageFences[imageIndex] = frame.fence;
+    }
+}
+
+void Engine::pushTimelineSubmissions(const Frame &frame, uint32_t commandsIndex)
+{
+    // Earth rendering:
+
+    submitter.pushSubmit(device->getGraphicsQueue(), frame.earthRenderingCommands);
+    submitter.pushSignal(timelines[TIMELINE_TYPE_EARTH]->get(), frame.number);
+
+    // Computing:
+
+    submitter.pushSubmit(device->getComputeQueue(), computingCommands[commandsIndex]);
+    submitter.pushWait(timelines[TIMELINE_TYPE_EARTH]->get(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, frame.number);
+    submitter.pushWait(frame.imageAvailable, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    submitter.pushSignal(timelines[TIMELINE_TYPE_POST]->get(), frame.number);
+
+    // Gallery rendering:
+
+    submitter.pushSubmit(device->getGraphicsQueue(), galleryRenderingCommands[commandsIndex]);
+    submitter.pushWait(timelines[TIMELINE_TYPE_POST]->get(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, frame.number);
+    submitter.pushSignal(timelines[TIMELINE_TYPE_GALLERY]->get(), frame.number);
+    submitter.pushSignal(frame.galleryRenderingFinished);
+}
+
+void Engine::pushBinarySubmissions(const Frame &frame, uint32_t commandsIndex)
+{
+    // attachments of this frame aren't read by computing anymore (frame fence is awaited),
+    // so earth rendering doesn't wait for computing of previous frames
+
+    // Earth rendering:
+
+    submitter.pushSubmit(device->getGraphicsQueue(), frame.earthRenderingCommands);
+    submitter.pushSignal(frame.earthRenderingFinished);
+
+    // Computing:
+
+    submitter.pushSubmit(device->getComputeQueue(), computingCommands[commandsIndex]);
+    submitter.pushWait(frame.earthRenderingFinished, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    submitter.pushWait(frame.imageAvailable, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    submitter.pushSignal(frame.computingFinished);
+
+    // Gallery rendering:
+
+    submitter.pushSubmit(device->getGraphicsQueue(), galleryRenderingCommands[commandsIndex]);
+    submitter.pushWait(frame.computingFinished, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+    submitter.pushSignal(frame.galleryRenderingFinished);
+}
+
 void Engine::initEarthRenderingCommands()
+{
+    for (uint32_t i = 0; i < frameCount; i++)
+    {
+        initEarthRenderingCommands(i);
+    }
+
+    LOGI("Earth rendering commands initialized.");
+}
+
+void Engine::initEarthRenderingCommands(uint32_t i)
 {
     const VkCommandPool commandPool = device->getCommandPool();
+    const QueueFamilyIndices queueFamilyIndices = device->getQueueFamilyIndices();
+    const uint32_t graphicsFamilyIndex = queueFamilyIndices.getGraphics();
+    const uint32_t computeFamilyIndex = queueFamilyIndices.getCompute();
 
-    if (earthRenderingCommands)
+    Frame &frame = frames[i];
+
+    if (frame.earthRenderingCommands)
     {
-        vkFreeCommandBuffers(device->get(), commandPool, 1, &earthRenderingCommands);
+        vkFreeCommandBuffers(device->get(), commandPool, 1, &frame.earthRenderingCommands);
     }
 
     VkCommandBufferAllocateInfo allocInfo{
@@ -619,18 +878,23 @@ void Engine::initEarthRenderingCommands()
         1,
     };
 
-    CALL_VK(vkAllocateCommandBuffers(device->get(), &allocInfo, &earthRenderingCommands));
+    CALL_VK(vkAllocateCommandBuffers(device->get(), &allocInfo, &frame.earthRenderingCommands));
+
+    const VkCommandBuffer earthRenderingCommands = frame.earthRenderingCommands;
 
     VkCommandBufferBeginInfo beginInfo{
         VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
         nullptr,
-        VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+        0,
         nullptr,
     };
 
     CALL_VK(vkBeginCommandBuffer(earthRenderingCommands, &beginInfo));
 
     {
+        // every dynamic uniform buffer of scene and models is shifted to the part of this frame
+        const std::vector<uint32_t> dynamicOffsets(3, scene->getUniformDynamicOffset(i));
+
         const VkRect2D renderArea{
         { 0, 0 },
         earthRenderPass->getExtent()
@@ -640,7 +904,7 @@ void Engine::initEarthRenderingCommands()
             VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
             nullptr,
             earthRenderPass->get(),
-            earthRenderPass->getFramebuffers().front(),
+            earthRenderPass->getFramebuffers()[i],
             renderArea,
             uint32_t(clearValues.size()),
             clearValues.data()
@@ -653,7 +917,7 @@ void Engine::initEarthRenderingCommands()
         vkCmdBindPipeline(earthRenderingCommands, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines[PIPELINE_TYPE_SKYBOX]->get());
         std::vector<VkDescriptorSet> descriptorSets{
             descriptors[DESCRIPTOR_TYPE_SCENE]->getDescriptorSet(0),
-            descriptors[DESCRIPTOR_TYPE_CLOUDS_AND_SKYBOX]->getDescriptorSet(1)
+            descriptors[DESCRIPTOR_TYPE_CLOUDS_AND_SKYBOX]->getDescriptorSet(frameCount)
         };
         vkCmdBindDescriptorSets(
             earthRenderingCommands,
@@ -662,8 +926,8 @@ void Engine::initEarthRenderingCommands()
             0,
             descriptorSets.size(),
             descriptorSets.data(),
-            0,
-            nullptr);
+            dynamicOffsets.size(),
+            dynamicOffsets.data());
         scene->drawCube(earthRenderingCommands);
 
         // Earth:
@@ -671,7 +935,7 @@ void Engine::initEarthRenderingCommands()
         vkCmdBindPipeline(earthRenderingCommands, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines[PIPELINE_TYPE_EARTH]->get());
         descriptorSets = {
             descriptors[DESCRIPTOR_TYPE_SCENE]->getDescriptorSet(0),
-            descriptors[DESCRIPTOR_TYPE_EARTH]->getDescriptorSet(0)
+            descriptors[DESCRIPTOR_TYPE_EARTH]->getDescriptorSet(i)
         };
         vkCmdBindDescriptorSets(
             earthRenderingCommands,
@@ -680,8 +944,8 @@ void Engine::initEarthRenderingCommands()
             0,
             descriptorSets.size(),
             descriptorSets.data(),
-            0,
-            nullptr);
+            dynamicOffsets.size(),
+            dynamicOffsets.data());
         scene->drawSphere(earthRenderingCommands);
 
         // Clouds:
@@ -689,7 +953,7 @@ void Engine::initEarthRenderingCommands()
         vkCmdBindPipeline(earthRenderingCommands, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines[PIPELINE_TYPE_CLOUDS]->get());
         descriptorSets = {
             descriptors[DESCRIPTOR_TYPE_SCENE]->getDescriptorSet(0),
-            descriptors[DESCRIPTOR_TYPE_CLOUDS_AND_SKYBOX]->getDescriptorSet(0)
+            descriptors[DESCRIPTOR_TYPE_CLOUDS_AND_SKYBOX]->getDescriptorSet(i)
         };
         vkCmdBindDescriptorSets(
             earthRenderingCommands,
@@ -698,22 +962,91 @@ void Engine::initEarthRenderingCommands()
             0,
             descriptorSets.size(),
             descriptorSets.data(),
-            0,
-            nullptr);
+            dynamicOffsets.size(),
+            dynamicOffsets.data());
         scene->drawSphere(earthRenderingCommands);
 
         vkCmdEndRenderPass(earthRenderingCommands);
+
+        // Mipmaps (blit requires graphics queue):
+
+        const auto colorTexture = earthRenderPass->getColorTexture(i);
+
+        colorTexture->memoryBarrier(
+            earthRenderingCommands,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            {
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                0,
+                1,
+                0,
+                1
+            });
+        colorTexture->memoryBarrier(
+            earthRenderingCommands,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            0,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            {
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                1,
+                colorTexture->getMipLevelCount() - 1,
+                0,
+                1
+            });
+
+        colorTexture->generateMipmaps(
+            earthRenderingCommands,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_FILTER_LINEAR,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+        // release color texture to computing queue family
+        if (graphicsFamilyIndex != computeFamilyIndex)
+        {
+            colorTexture->memoryBarrier(
+                earthRenderingCommands,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_ACCESS_TRANSFER_WRITE_BIT,
+                0,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                {
+                    VK_IMAGE_ASPECT_COLOR_BIT,
+                    0,
+                    colorTexture->getMipLevelCount(),
+                    0,
+                    1
+                },
+                graphicsFamilyIndex,
+                computeFamilyIndex);
+        }
     }
 
     CALL_VK(vkEndCommandBuffer(earthRenderingCommands));
-
-    LOGI("Earth rendering commands initialized.");
 }
 
 void Engine::initComputingCommands()
 {
-    const VkCommandPool commandPool = device->getCommandPool();
-    const uint32_t count = swapChain->getImageCount();
+    const VkCommandPool commandPool = device->getComputeCommandPool();
+    const QueueFamilyIndices queueFamilyIndices = device->getQueueFamilyIndices();
+    const uint32_t graphicsFamilyIndex = queueFamilyIndices.getGraphics();
+    const uint32_t computeFamilyIndex = queueFamilyIndices.getCompute();
+    const uint32_t imageCount = swapChain->getImageCount();
+
+    // one command buffer for each pair of frame and swapchain image
+    const uint32_t count = frameCount * imageCount;
 
     if (!computingCommands.empty())
     {
@@ -734,6 +1067,10 @@ void Engine::initComputingCommands()
 
     for (uint32_t i = 0; i < count; i++)
     {
+        const uint32_t frame = i / imageCount;
+        const uint32_t image = i % imageCount;
+
+        const auto colorTexture = earthRenderPass->getColorTexture(frame);
 
         VkCommandBufferBeginInfo beginInfo{
             VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
@@ -745,50 +1082,49 @@ void Engine::initComputingCommands()
         CALL_VK(vkBeginCommandBuffer(computingCommands[i], &beginInfo));
 
         {
-            const auto colorTexture = earthRenderPass->getColorTexture();
-
-            colorTexture->memoryBarrier(
-                computingCommands[i],
-                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT,
-                VK_ACCESS_TRANSFER_WRITE_BIT,
-                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                VK_PIPELINE_STAGE_TRANSFER_BIT,
-                {
-                    VK_IMAGE_ASPECT_COLOR_BIT, 
+            // acquire color texture with mipmaps from graphics queue family
+            if (graphicsFamilyIndex != computeFamilyIndex)
+            {
+                colorTexture->memoryBarrier(
+                    computingCommands[i],
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
                     0,
-                    1, 
-                    0, 
-                    1
-                });
-            colorTexture->memoryBarrier(
+                    VK_ACCESS_SHADER_READ_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    {
+                        VK_IMAGE_ASPECT_COLOR_BIT,
+                        0,
+                        colorTexture->getMipLevelCount(),
+                        0,
+                        1
+                    },
+                    graphicsFamilyIndex,
+                    computeFamilyIndex);
+            }
+
+            // luminosity is shared by frames in flight (all of them are computed by one queue),
+            // so it's adapted only after previous frame has finished adapting and reading it
+            luminosityImage->memoryBarrier(
                 computingCommands[i],
-                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                VK_ACCESS_SHADER_READ_BIT,
-                VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_IMAGE_LAYOUT_GENERAL,
+                VK_IMAGE_LAYOUT_GENERAL,
+                VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT,
+                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                VK_PIPELINE_STAGE_TRANSFER_BIT,
                 {
                     VK_IMAGE_ASPECT_COLOR_BIT,
+                    0,
                     1,
-                    colorTexture->getMipLevelCount() - 1,
                     0,
                     1
                 });
 
-            colorTexture->generateMipmaps(
-                computingCommands[i],
-                VK_IMAGE_ASPECT_COLOR_BIT,
-                VK_FILTER_LINEAR,
-                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                VK_ACCESS_SHADER_READ_BIT,
-                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
-
             vkCmdBindPipeline(computingCommands[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelines[PIPELINE_TYPE_LUMINOSITY]->get());
             std::vector<VkDescriptorSet> lumDescriptorSets{
-                descriptors[DESCRIPTOR_TYPE_LUMINOSITY_SRC]->getDescriptorSet(0),
+                descriptors[DESCRIPTOR_TYPE_LUMINOSITY_SRC]->getDescriptorSet(frame),
                 descriptors[DESCRIPTOR_TYPE_LUMINOSITY_DST]->getDescriptorSet(0)
             };
             vkCmdBindDescriptorSets(
@@ -802,14 +1138,32 @@ void Engine::initComputingCommands()
                 nullptr);
             vkCmdDispatch(computingCommands[i], 1, 1, 1);
 
-            const auto swapChainImage = swapChain->getImages()[i];
+            // tone reads luminosity written by previous dispatch
+            luminosityImage->memoryBarrier(
+                computingCommands[i],
+                VK_IMAGE_LAYOUT_GENERAL,
+                VK_IMAGE_LAYOUT_GENERAL,
+                VK_ACCESS_SHADER_WRITE_BIT,
+                VK_ACCESS_SHADER_READ_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                {
+                    VK_IMAGE_ASPECT_COLOR_BIT,
+                    0,
+                    1,
+                    0,
+                    1
+                });
+
+            // swapchain image is fully overwritten, so previous content is discarded
+            const auto swapChainImage = swapChain->getImages()[image];
             swapChainImage->memoryBarrier(
                 computingCommands[i],
-                VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                VK_IMAGE_LAYOUT_UNDEFINED,
                 VK_IMAGE_LAYOUT_GENERAL,
                 0,
                 VK_ACCESS_SHADER_WRITE_BIT,
-                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                 {
                     VK_IMAGE_ASPECT_COLOR_BIT,
@@ -822,8 +1176,8 @@ void Engine::initComputingCommands()
             vkCmdBindPipeline(computingCommands[i], VK_PIPELINE_BIND_POINT_COMPUTE, pipelines[PIPELINE_TYPE_TONE]->get());
             std::vector<VkDescriptorSet> toneDescriptorSets{
                 descriptors[DESCRIPTOR_TYPE_LUMINOSITY_DST]->getDescriptorSet(0),
-                descriptors[DESCRIPTOR_TYPE_TONE_SRC]->getDescriptorSet(0),
-                descriptors[DESCRIPTOR_TYPE_TONE_DST]->getDescriptorSet(i)
+                descriptors[DESCRIPTOR_TYPE_TONE_SRC]->getDescriptorSet(frame),
+                descriptors[DESCRIPTOR_TYPE_TONE_DST]->getDescriptorSet(image)
             };
             vkCmdBindDescriptorSets(
                 computingCommands[i],
@@ -837,38 +1191,6 @@ void Engine::initComputingCommands()
 
             const auto imageExtent = swapChain->getExtent();
             vkCmdDispatch(computingCommands[i], imageExtent.width / localGroupSize.x, imageExtent.height / localGroupSize.y, 1);
-
-            colorTexture->memoryBarrier(
-                computingCommands[i],
-                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                VK_ACCESS_SHADER_READ_BIT,
-                VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT,
-                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                VK_PIPELINE_STAGE_TRANSFER_BIT,
-                {
-                    VK_IMAGE_ASPECT_COLOR_BIT,
-                    0,
-                    1,
-                    0,
-                    1
-                });
-
-            swapChainImage->memoryBarrier(
-                computingCommands[i],
-                VK_IMAGE_LAYOUT_GENERAL,
-                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                VK_ACCESS_SHADER_WRITE_BIT,
-                VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                {
-                    VK_IMAGE_ASPECT_COLOR_BIT,
-                    0,
-                    1,
-                    0,
-                    1
-                });
         }
 
         CALL_VK(vkEndCommandBuffer(computingCommands[i]));
@@ -880,7 +1202,10 @@ void Engine::initComputingCommands()
 void Engine::initGalleryRenderingCommands()
 {
     const VkCommandPool commandPool = device->getCommandPool();
-    const uint32_t count = swapChain->getImageCount();
+    const uint32_t imageCount = swapChain->getImageCount();
+
+    // one command buffer for each pair of frame and swapchain image
+    const uint32_t count = frameCount * imageCount;
 
     if (!galleryRenderingCommands.empty())
     {
@@ -901,6 +1226,8 @@ void Engine::initGalleryRenderingCommands()
 
     for (uint32_t i = 0; i < count; i++)
     {
+        const uint32_t frame = i / imageCount;
+        const uint32_t image = i % imageCount;
 
         VkCommandBufferBeginInfo beginInfo{
             VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
@@ -912,6 +1239,23 @@ void Engine::initGalleryRenderingCommands()
         CALL_VK(vkBeginCommandBuffer(galleryRenderingCommands[i], &beginInfo));
 
         {
+            // swapchain image is shared concurrently, so only layout is changed after computing
+            swapChain->getImages()[image]->memoryBarrier(
+                galleryRenderingCommands[i],
+                VK_IMAGE_LAYOUT_GENERAL,
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                0,
+                VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                {
+                    VK_IMAGE_ASPECT_COLOR_BIT,
+                    0,
+                    1,
+                    0,
+                    1
+                });
+
             const VkRect2D renderArea{
             { 0, 0 },
             galleryRenderPass->getExtent()
@@ -921,7 +1265,7 @@ void Engine::initGalleryRenderingCommands()
                 VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
                 nullptr,
                 galleryRenderPass->get(),
-                galleryRenderPass->getFramebuffers()[i],
+                galleryRenderPass->getFramebuffers()[image],
                 renderArea,
                 uint32_t(clearValues.size()),
                 clearValues.data()
@@ -934,6 +1278,7 @@ void Engine::initGalleryRenderingCommands()
                 descriptors[DESCRIPTOR_TYPE_SCENE]->getDescriptorSet(0),
                 descriptors[DESCRIPTOR_TYPE_GALLERY]->getDescriptorSet(0),
             };
+            const std::vector<uint32_t> dynamicOffsets(4, scene->getUniformDynamicOffset(frame));
             vkCmdBindDescriptorSets(
                 galleryRenderingCommands[i],
                 VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -941,8 +1286,8 @@ void Engine::initGalleryRenderingCommands()
                 0,
                 descriptorSets.size(),
                 descriptorSets.data(),
-                0,
-                nullptr);
+                dynamicOffsets.size(),
+                dynamicOffsets.data());
 
             scene->drawCard(galleryRenderingCommands[i]);
 
@@ -955,27 +1300,59 @@ void Engine::initGalleryRenderingCommands()
     LOGI("Gallery rendering commands initialized.");
 }
 
-void Engine::updateChangedDescriptorSets()
+void Engine::publishStreamedTextures()
 {
-    const auto colorTexture = earthRenderPass->getColorTexture();
+    // pending frames keep sampling previous views, which are destroyed when the last submitted frame is completed,
+    // descriptor sets of each frame are updated when the frame is completed (see updateFrameTextures)
+    scene->publishTextures(frameNumber);
+    publishCount++;
+}
 
-    descriptors[DESCRIPTOR_TYPE_LUMINOSITY_SRC]->updateDescriptorSet(
-        0,
+void Engine::updateFrameTextures(uint32_t index)
+{
+    descriptors[DESCRIPTOR_TYPE_EARTH]->updateDescriptorSet(
+        index,
         {
-            {
-                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                { colorTexture->getCombineSamplerInfo(0, 1) }
-            }
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, scene->getModelTextureInfos(Scene::ModelId::EARTH) },
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, { scene->getModelTransformationBufferInfo(Scene::ModelId::EARTH) } }
         });
-
-    descriptors[DESCRIPTOR_TYPE_TONE_SRC]->updateDescriptorSet(
-        0,
+    descriptors[DESCRIPTOR_TYPE_CLOUDS_AND_SKYBOX]->updateDescriptorSet(
+        index,
         {
-            {
-                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                { colorTexture->getCombineSamplerInfo() }
-            }
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, scene->getModelTextureInfos(Scene::ModelId::CLOUDS) },
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, { scene->getModelTransformationBufferInfo(Scene::ModelId::CLOUDS) } }
         });
+
+    // updated descriptor sets invalidate commands which bind them
+    initEarthRenderingCommands(index);
+
+    frames[index].publishCount = publishCount;
+}
+
+void Engine::updateChangedDescriptorSets()
+{
+    for (uint32_t i = 0; i < frameCount; i++)
+    {
+        const auto colorTexture = earthRenderPass->getColorTexture(i);
+
+        descriptors[DESCRIPTOR_TYPE_LUMINOSITY_SRC]->updateDescriptorSet(
+            i,
+            {
+                {
+                    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                    { colorTexture->getCombineSamplerInfo(0, 1) }
+                }
+            });
+
+        descriptors[DESCRIPTOR_TYPE_TONE_SRC]->updateDescriptorSet(
+            i,
+            {
+                {
+                    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                    { colorTexture->getCombineSamplerInfo() }
+                }
+            });
+    }
     const auto swapChainImages = swapChain->getImages();
     for (uint32_t i = 0; i < swapChainImages.size(); i++)
     {
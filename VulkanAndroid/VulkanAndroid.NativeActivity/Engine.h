@@ -9,11 +9,16 @@
 #include "Scene.h"
 #include "DescriptorSets.h"
 #include "GalleryRenderPass.h"
+#include "FrameSubmitter.h"
+#include "TimelineSemaphore.h"
 
 class Engine
 {
 public:
-    Engine();
+    // frameCount - number of frames that CPU can prepare ahead of GPU (1 - 3),
+    // swapChainPolicy - latency or throughput priority of presentation,
+    // idleFps - rate of rendering when scene is static except earth rotation, 0 - no rendering
+    Engine(uint32_t frameCount, SwapChain::Policy swapChainPolicy, float idleFps);
 
 	~Engine();
 
@@ -35,6 +40,20 @@ public:
 
     void activateGallery();
 
+    // number of vkQueueSubmit calls of the last drawn frame:
+    // 3 with separate compute queue, 1 if computing is submitted to graphics queue
+    uint32_t getFrameSubmitCount() const;
+
+    // number of frames which weren't rendered because scene wasn't changed
+    uint64_t getSkippedFrameCount() const;
+
+    // device memory usage by categories, high-water marks and heap budgets,
+    // number of skipped frames and queue submits of the last frame
+    std::string getMemoryReport() const;
+
+    // writes memory report to log and internal storage of application
+    void dumpMemoryReport() const;
+
     bool drawFrame();
 
     bool destroy();
@@ -64,6 +83,44 @@ private:
         PIPELINE_TYPE_COUNT
     };
 
+    // timeline semaphore for each pass, value of every pass is number of frame
+    enum TimelineType
+    {
+        TIMELINE_TYPE_EARTH,
+        TIMELINE_TYPE_POST,
+        TIMELINE_TYPE_GALLERY,
+        TIMELINE_TYPE_COUNT
+    };
+
+    // synchronization and commands which belong to one frame in flight
+    struct Frame
+    {
+        // binary semaphores are required by swapchain
+        VkSemaphore imageAvailable;
+
+        VkSemaphore galleryRenderingFinished;
+
+        // used only without timeline semaphores
+        VkSemaphore earthRenderingFinished;
+
+        VkSemaphore computingFinished;
+
+        // signaled when all commands of frame are completed (without timeline semaphores)
+        VkFence fence;
+
+        // number of the last frame submitted in this slot
+        uint64_t number;
+
+        // streamed textures are bound by descriptor sets of this slot after this number of publishings
+        uint32_t publishCount;
+
+        VkCommandBuffer earthRenderingCommands;
+    };
+
+    static const uint32_t MAX_FRAME_COUNT = 3;
+
+    const std::string MEMORY_REPORT_FILE = "memory_report.txt";
+
     bool created;
 
     bool outdated;
@@ -92,19 +149,35 @@ private:
 
     Scene *scene;
 
-    // TODO: combine semaphores
+    uint32_t frameCount;
+
+    SwapChain::Policy swapChainPolicy;
+
+    float idleFps;
+
+    uint64_t skippedFrameCount = 0;
+
+    uint32_t frameIndex = 0;
 
-    VkSemaphore earthRenderingFinished;
+    std::vector<Frame> frames;
 
-    VkSemaphore computingFinished;
+    bool timelineEnabled;
 
-    VkSemaphore galleryRenderingFinished;
+    std::vector<TimelineSemaphore*> timelines;
 
-    VkSemaphore imageAvailable;
+    // number of the last submitted frame
+    uint64_t frameNumber = 0;
 
-    // TODO: combine commands
+    // number of publishings of streamed textures
+    uint32_t publishCount = 0;
 
-    VkCommandBuffer earthRenderingCommands{};
+    // fences of frames which use swapchain images (without timeline semaphores)
+    std::vector<VkFence> imageFences;
+
+    // numbers of frames which use swapchain images (with timeline semaphores)
+    std::vector<uint64_t> imageFrameNumbers;
+
+    FrameSubmitter submitter;
 
     glm::uvec2 localGroupSize{ 16 };
 
@@ -122,12 +195,37 @@ private:
 
     VkSemaphore createSemaphore() const;
 
+    VkFence createFence() const;
+
+    void createFrames();
+
+    void destroyFrames();
+
+    // waits until GPU finishes the previous frame submitted in this slot
+    void waitFrame(const Frame &frame) const;
+
+    // waits until GPU finishes the frame which uses swapchain image and makes this frame its owner
+    void waitImage(uint32_t imageIndex, const Frame &frame);
+
+    void pushTimelineSubmissions(const Frame &frame, uint32_t commandsIndex);
+
+    void pushBinarySubmissions(const Frame &frame, uint32_t commandsIndex);
+
     void initEarthRenderingCommands();
 
+    // records commands of frame with index i
+    void initEarthRenderingCommands(uint32_t i);
+
     void initComputingCommands();
 
     void initGalleryRenderingCommands();
 
     void updateChangedDescriptorSets();
+
+    // makes streamed mip levels visible, textures of earth and clouds are rebound for each frame later
+    void publishStreamedTextures();
+
+    // rebinds published textures of earth and clouds to frame which isn't used by GPU
+    void updateFrameTextures(uint32_t index);
 };
 
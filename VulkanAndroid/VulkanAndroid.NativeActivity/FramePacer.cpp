@@ -0,0 +1,38 @@
+#include "FramePacer.h"
+#include <algorithm>
+
+FramePacer::FramePacer(const VsyncSource *vsyncSource, float maxFps)
+    : vsyncSource(vsyncSource), minFrameDuration(0), nextFrameTime(steady_clock::now())
+{
+    if (maxFps > 0)
+    {
+        minFrameDuration = nanoseconds(int64_t(1000000000.0 / maxFps));
+    }
+}
+
+int FramePacer::getTimeoutMillis() const
+{
+    const time_point<steady_clock> now = steady_clock::now();
+
+    if (now >= nextFrameTime)
+    {
+        return 0;
+    }
+
+    // round up to wake up not earlier than frame time
+    const auto timeout = duration_cast<milliseconds>(nextFrameTime - now + milliseconds(1) - nanoseconds(1));
+
+    return int(timeout.count());
+}
+
+void FramePacer::beginFrame()
+{
+    const time_point<steady_clock> now = steady_clock::now();
+
+    // next vsync after current one which isn't earlier than frame rate cap allows
+    const time_point<steady_clock> earliestTime = (std::max)(
+        now + VSYNC_TOLERANCE,
+        now + minFrameDuration - VSYNC_TOLERANCE);
+
+    nextFrameTime = vsyncSource->getNextVsync(earliestTime);
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "VsyncSource.h"
+
+// schedules start of frames at vsync time points and limits frame rate
+class FramePacer
+{
+public:
+    // maxFps - frame rate cap, 0 - no cap (display refresh rate)
+    FramePacer(const VsyncSource *vsyncSource, float maxFps);
+
+    // time in milliseconds until start of next frame, 0 if frame must be started now
+    int getTimeoutMillis() const;
+
+    // saves start of current frame and schedules next frame
+    void beginFrame();
+
+private:
+    // vsync time points are compared with wakeup time which has millisecond precision
+    const nanoseconds VSYNC_TOLERANCE = milliseconds(2);
+
+    const VsyncSource *vsyncSource;
+
+    nanoseconds minFrameDuration;
+
+    time_point<steady_clock> nextFrameTime;
+};
+
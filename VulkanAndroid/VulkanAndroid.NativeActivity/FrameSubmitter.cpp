@@ -0,0 +1,113 @@
+#include "FrameSubmitter.h"
+
+void FrameSubmitter::begin()
+{
+    LOGA(submissionCount == 0);
+
+    frameSubmitCount = 0;
+}
+
+void FrameSubmitter::pushSubmit(VkQueue queue, VkCommandBuffer commandBuffer)
+{
+    LOGA(submissionCount < MAX_SUBMIT_COUNT);
+
+    Submission &submission = submissions[submissionCount++];
+    submission.queue = queue;
+    submission.commandBuffer = commandBuffer;
+    submission.waitCount = 0;
+    submission.signalCount = 0;
+    submission.timeline = false;
+}
+
+void FrameSubmitter::pushWait(VkSemaphore semaphore, VkPipelineStageFlags stage, uint64_t value)
+{
+    LOGA(submissionCount > 0);
+
+    Submission &submission = submissions[submissionCount - 1];
+
+    LOGA(submission.waitCount < MAX_SEMAPHORE_COUNT);
+
+    submission.waitSemaphores[submission.waitCount] = semaphore;
+    submission.waitStages[submission.waitCount] = stage;
+    submission.waitValues[submission.waitCount] = value;
+    submission.waitCount++;
+    submission.timeline |= value > 0;
+}
+
+void FrameSubmitter::pushSignal(VkSemaphore semaphore, uint64_t value)
+{
+    LOGA(submissionCount > 0);
+
+    Submission &submission = submissions[submissionCount - 1];
+
+    LOGA(submission.signalCount < MAX_SEMAPHORE_COUNT);
+
+    submission.signalSemaphores[submission.signalCount] = semaphore;
+    submission.signalValues[submission.signalCount] = value;
+    submission.signalCount++;
+    submission.timeline |= value > 0;
+}
+
+void FrameSubmitter::flush(VkFence fence)
+{
+    for (uint32_t i = 0; i < submissionCount; i++)
+    {
+        const Submission &submission = submissions[i];
+
+        // values of binary semaphores are ignored
+        timelineInfos[i] = VkTimelineSemaphoreSubmitInfoKHR{
+            VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
+            nullptr,
+            submission.waitCount,
+            submission.waitValues.data(),
+            submission.signalCount,
+            submission.signalValues.data(),
+        };
+
+        submitInfos[i] = VkSubmitInfo{
+            VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            submission.timeline ? &timelineInfos[i] : nullptr,
+            submission.waitCount,
+            submission.waitSemaphores.data(),
+            submission.waitStages.data(),
+            1,
+            &submission.commandBuffer,
+            submission.signalCount,
+            submission.signalSemaphores.data(),
+        };
+    }
+
+    // order of submissions is kept, so every semaphore is signaled by a batch
+    // which has been already submitted before the batch waiting for it
+    uint32_t first = 0;
+    while (first < submissionCount)
+    {
+        const VkQueue queue = submissions[first].queue;
+
+        uint32_t last = first + 1;
+        while (last < submissionCount && submissions[last].queue == queue)
+        {
+            last++;
+        }
+
+        const VkFence submitFence = last == submissionCount ? fence : VK_NULL_HANDLE;
+        CALL_VK(vkQueueSubmit(queue, last - first, &submitInfos[first], submitFence));
+
+        frameSubmitCount++;
+        totalSubmitCount++;
+
+        first = last;
+    }
+
+    submissionCount = 0;
+}
+
+uint32_t FrameSubmitter::getFrameSubmitCount() const
+{
+    return frameSubmitCount;
+}
+
+uint64_t FrameSubmitter::getTotalSubmitCount() const
+{
+    return totalSubmitCount;
+}
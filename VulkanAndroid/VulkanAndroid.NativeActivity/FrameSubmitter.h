@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+
+// collects submissions of one frame in fixed-size storage and flushes them
+// with one vkQueueSubmit for each run of consecutive submissions to the same queue:
+// frame of Engine (graphics -> compute -> graphics) takes three vkQueueSubmit calls
+// if compute queue is separate and only one if graphics queue is used for computing
+class FrameSubmitter
+{
+public:
+    static const uint32_t MAX_SUBMIT_COUNT = 8;
+
+    static const uint32_t MAX_SEMAPHORE_COUNT = 4;
+
+    // starts new frame, all previously pushed submissions must be flushed
+    void begin();
+
+    void pushSubmit(VkQueue queue, VkCommandBuffer commandBuffer);
+
+    // adds wait semaphore to the last pushed submission,
+    // non-zero value is awaited value of timeline semaphore
+    void pushWait(VkSemaphore semaphore, VkPipelineStageFlags stage, uint64_t value = 0);
+
+    // adds signal semaphore to the last pushed submission,
+    // non-zero value is signaled value of timeline semaphore
+    void pushSignal(VkSemaphore semaphore, uint64_t value = 0);
+
+    // fence is signaled by the last vkQueueSubmit of frame
+    void flush(VkFence fence);
+
+    // number of vkQueueSubmit calls in the last flushed frame
+    uint32_t getFrameSubmitCount() const;
+
+    // number of vkQueueSubmit calls since creation
+    uint64_t getTotalSubmitCount() const;
+
+private:
+    struct Submission
+    {
+        VkQueue queue;
+
+        VkCommandBuffer commandBuffer;
+
+        uint32_t waitCount;
+
+        std::array<VkSemaphore, MAX_SEMAPHORE_COUNT> waitSemaphores;
+
+        std::array<VkPipelineStageFlags, MAX_SEMAPHORE_COUNT> waitStages;
+
+        std::array<uint64_t, MAX_SEMAPHORE_COUNT> waitValues;
+
+        uint32_t signalCount;
+
+        std::array<VkSemaphore, MAX_SEMAPHORE_COUNT> signalSemaphores;
+
+        std::array<uint64_t, MAX_SEMAPHORE_COUNT> signalValues;
+
+        // submission uses timeline semaphores
+        bool timeline;
+    };
+
+    std::array<Submission, MAX_SUBMIT_COUNT> submissions;
+
+    std::array<VkTimelineSemaphoreSubmitInfoKHR, MAX_SUBMIT_COUNT> timelineInfos;
+
+    std::array<VkSubmitInfo, MAX_SUBMIT_COUNT> submitInfos;
+
+    uint32_t submissionCount = 0;
+
+    uint32_t frameSubmitCount = 0;
+
+    uint64_t totalSubmitCount = 0;
+};
+
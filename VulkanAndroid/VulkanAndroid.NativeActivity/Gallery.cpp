@@ -9,23 +9,24 @@
 
 Gallery::Gallery(
     Device *device,
+    TextureLoader *textureLoader,
+    RingBuffer *uniformBuffer,
     const std::string &path,
     Earth *earth,
     Camera *camera,
     Controller *controller)
-    : Model(device),
+    : Model(uniformBuffer),
     earth(earth),
     camera(camera),
     controller(controller)
 {
-    loadPhotographs(device, path);
+    loadPhotographs(device, textureLoader, path);
 
-    parameterBuffer = new Buffer(device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(Parameters));
+    parameterOffset = uniformBuffer->allocate(sizeof(Parameters));
 }
 
 Gallery::~Gallery()
 {
-    delete parameterBuffer;
     delete texture;
 }
 
@@ -36,7 +37,14 @@ std::vector<DescriptorInfo> Gallery::getTextureInfos() const
 
 std::vector<DescriptorInfo> Gallery::getUniformBufferInfos() const
 {
-    return { parameterBuffer->getUniformBufferInfo() };
+    return { uniformBuffer->getUniformBufferInfo(parameterOffset, sizeof(Parameters)) };
+}
+
+void Gallery::updateUniforms()
+{
+    Model::updateUniforms();
+
+    uniformBuffer->updateData(&parameters, parameterOffset, sizeof(Parameters));
 }
 
 void Gallery::update()
@@ -51,7 +59,7 @@ void Gallery::update()
     uint32_t index;
     const float nearestDistance = calculateNearestDistance(cameraCoordinates, &index);
 
-    Parameters parameters{ float(index), 0.0f };
+    parameters = Parameters{ float(index), 0.0f };
     const float distanceLimit = (controller->getRadius() - earth->getRadius()) * DISTANCE_LIMIT_FACTOR;
 
     if (nearestDistance < distanceLimit)
@@ -59,8 +67,6 @@ void Gallery::update()
         parameters.opacity = calculateOpacity(nearestDistance, distanceLimit);
         setTransformation(calculateTransformation(coordinates[index], cameraCoordinates));
     }
-
-    parameterBuffer->updateData(&parameters);
 }
 
 void Gallery::activate()
@@ -68,11 +74,11 @@ void Gallery::activate()
     activated = true;
 }
 
-void Gallery::loadPhotographs(Device *device, const std::string &path)
+void Gallery::loadPhotographs(Device *device, TextureLoader *textureLoader, const std::string &path)
 {
     std::vector<std::string> paths = ActivityManager::getFilePaths(path, { ".jpg", ".jpeg", ".png" });
 
-    std::vector<std::vector<uint8_t>> buffers;
+    std::vector<std::string> photoPaths;
     for (const auto &filePath : paths)
     {
         std::string fileName = file::getFileName(filePath);
@@ -81,7 +87,7 @@ void Gallery::loadPhotographs(Device *device, const std::string &path)
         if (coord.second)
         {
             coordinates.push_back(coord.first);
-            buffers.push_back(ActivityManager::read(filePath));
+            photoPaths.push_back(filePath);
         }
         else
         {
@@ -89,7 +95,7 @@ void Gallery::loadPhotographs(Device *device, const std::string &path)
         }
     }
 
-    empty = buffers.empty();
+    empty = photoPaths.empty();
     if (empty)
     {
         coordinates.emplace_back(0.0f);
@@ -103,20 +109,37 @@ void Gallery::loadPhotographs(Device *device, const std::string &path)
             VK_SAMPLE_COUNT_1_BIT,
             VK_IMAGE_USAGE_SAMPLED_BIT,
             false);
+        texture->pushFullView(VK_IMAGE_ASPECT_COLOR_BIT);
+        texture->pushSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER);
+        return;
     }
-    else
+
+    // photographs are read from external storage on worker threads too, each one by its own task
+    std::vector<TextureLoader::Reader> readers;
+    for (const auto &photoPath : photoPaths)
     {
-        texture = new TextureImage(device, buffers, false, false);
+        readers.push_back([photoPath]() { return ActivityManager::open(photoPath); });
+    }
 
-        std::set<uint32_t> failedImages = texture->getFailedImages();
-        for (auto it = failedImages.rbegin(); it != failedImages.rend(); ++it)
+    textureLoader->load(
+        path,
+        readers,
+        STBI_rgb_alpha,
+        false,
+        false,
+        [this](TextureImage *loadedTexture)
         {
-            coordinates.erase(coordinates.begin() + *it);
-        }
-    }
+            texture = loadedTexture;
+
+            std::set<uint32_t> failedImages = texture->getFailedImages();
+            for (auto it = failedImages.rbegin(); it != failedImages.rend(); ++it)
+            {
+                coordinates.erase(coordinates.begin() + *it);
+            }
 
-    texture->pushFullView(VK_IMAGE_ASPECT_COLOR_BIT);
-    texture->pushSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER);
+            texture->pushFullView(VK_IMAGE_ASPECT_COLOR_BIT);
+            texture->pushSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER);
+        });
 }
 
 Optional<glm::vec2> Gallery::getCoordinates(const std::string &fileName)
@@ -1,6 +1,6 @@
 #pragma once
 #include "Model.h"
-#include "TextureImage.h"
+#include "TextureLoader.h"
 #include "Earth.h"
 #include "Camera.h"
 #include "Controller.h"
@@ -9,7 +9,15 @@
 class Gallery : public Model
 {
 public:
-    Gallery(Device *device, const std::string &path, Earth *earth, Camera *camera, Controller *controller);
+    // photographs are decoded by loader together with other textures of scene
+    Gallery(
+        Device *device,
+        TextureLoader *textureLoader,
+        RingBuffer *uniformBuffer,
+        const std::string &path,
+        Earth *earth,
+        Camera *camera,
+        Controller *controller);
 
     virtual ~Gallery();
 
@@ -17,6 +25,8 @@ public:
 
     std::vector<DescriptorInfo> getUniformBufferInfos() const override;
 
+    void updateUniforms() override;
+
     void update();
 
     void activate();
@@ -32,7 +42,9 @@ private:
 
     const float SCALE_FACTOR = 0.4f;
 
-    Buffer *parameterBuffer;
+    Parameters parameters{ 0.0f, 0.0f };
+
+    VkDeviceSize parameterOffset;
 
     Earth *earth;
 
@@ -48,7 +60,7 @@ private:
 
     bool empty;
 
-    void loadPhotographs(Device *device, const std::string &path);
+    void loadPhotographs(Device *device, TextureLoader *textureLoader, const std::string &path);
 
     static Optional<glm::vec2> getCoordinates(const std::string &fileName);
 
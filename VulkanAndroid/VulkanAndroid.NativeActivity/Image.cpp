@@ -1,5 +1,6 @@
 #include "Image.h"
 #include "StagingBuffer.h"
+#include "UploadContext.h"
 #include "utils.h"
 
 Image::Image(
@@ -48,7 +49,7 @@ Image::~Image()
     if (!swapChainImage)
     {
         vkDestroyImage(device->get(), image, nullptr);
-        vkFreeMemory(device->get(), memory, nullptr);
+        device->getMemoryAllocator()->free(memory);
     }
 }
 
@@ -72,6 +73,11 @@ VkExtent3D Image::getExtent() const
 	return extent;
 }
 
+bool Image::isConcurrent() const
+{
+    return concurrent;
+}
+
 VkSampleCountFlagBits Image::getSampleCount() const
 {
 	return sampleCount;
@@ -156,7 +162,9 @@ void Image::memoryBarrier(
     VkAccessFlags dstAccessMask,
     VkPipelineStageFlags srcStageMask,
     VkPipelineStageFlags dstStageMask,
-    VkImageSubresourceRange subresourceRange)
+    VkImageSubresourceRange subresourceRange,
+    uint32_t srcQueueFamilyIndex,
+    uint32_t dstQueueFamilyIndex)
 {
     const VkImageMemoryBarrier barrier{
         VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
@@ -165,8 +173,8 @@ void Image::memoryBarrier(
         dstAccessMask,
         oldLayout,
         newLayout,
-        VK_QUEUE_FAMILY_IGNORED,
-        VK_QUEUE_FAMILY_IGNORED,
+        srcQueueFamilyIndex,
+        dstQueueFamilyIndex,
         image,
         subresourceRange,
     };
@@ -181,14 +189,13 @@ void Image::memoryBarrier(
 }
 
 void Image::transitLayout(
+    VkCommandBuffer commandBuffer,
     VkImageLayout oldLayout,
     VkImageLayout newLayout,
     VkPipelineStageFlags srcStageMask,
     VkPipelineStageFlags dstStageMask,
     VkImageSubresourceRange subresourceRange)
 {
-	VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
-
     VkAccessFlags srcAccessMask{};
     VkAccessFlags dstAccessMask{};
 
@@ -296,11 +303,27 @@ void Image::transitLayout(
         srcStageMask,
         dstStageMask,
         subresourceRange);
+}
+
+void Image::transitLayout(
+    VkImageLayout oldLayout,
+    VkImageLayout newLayout,
+    VkPipelineStageFlags srcStageMask,
+    VkPipelineStageFlags dstStageMask,
+    VkImageSubresourceRange subresourceRange)
+{
+	VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
+
+    transitLayout(commandBuffer, oldLayout, newLayout, srcStageMask, dstStageMask, subresourceRange);
 
 	device->endOneTimeCommands(commandBuffer);
 }
 
-void Image::updateData(std::vector<const void*> data, uint32_t layersOffset, uint32_t pixelSize)
+StagingBuffer* Image::updateData(
+    VkCommandBuffer commandBuffer,
+    const std::vector<const void*> &data,
+    uint32_t layersOffset,
+    uint32_t pixelSize)
 {
 	const auto updatedLayers = uint32_t(data.size());
 
@@ -315,11 +338,8 @@ void Image::updateData(std::vector<const void*> data, uint32_t layersOffset, uin
 	};
 	const VkDeviceSize layerSize = extent.width * extent.height * pixelSize;
 
-	StagingBuffer stagingBuffer(device, layerSize * updatedLayers);
-	for (uint32_t i = 0; i < updatedLayers; i++)
-	{
-		stagingBuffer.updateData(data[i], i * layerSize,layerSize);
-	}
+	auto stagingBuffer = new StagingBuffer(device, layerSize * updatedLayers);
+	stagingBuffer->updateLayers(data, layerSize);
 
 	std::vector<VkBufferImageCopy> regions(updatedLayers);
 	for (uint32_t i = 0; i < updatedLayers; i++)
@@ -341,13 +361,27 @@ void Image::updateData(std::vector<const void*> data, uint32_t layersOffset, uin
 
 	// before copying the layout of the image must be TRANSFER_DST
 	transitLayout(
+		commandBuffer,
 		VK_IMAGE_LAYOUT_UNDEFINED,
 		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
         VK_PIPELINE_STAGE_TRANSFER_BIT,
 		subresourceRange);
 
-	stagingBuffer.copyToImage(image, regions);
+	stagingBuffer->copyToImage(commandBuffer, image, regions);
+
+	return stagingBuffer;
+}
+
+void Image::updateData(const std::vector<const void*> &data, uint32_t layersOffset, uint32_t pixelSize)
+{
+	VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
+
+	StagingBuffer *stagingBuffer = updateData(commandBuffer, data, layersOffset, pixelSize);
+
+	device->endOneTimeCommands(commandBuffer);
+
+	releaseStagingBuffer(stagingBuffer);
 }
 
 void Image::blitTo(
@@ -555,7 +589,8 @@ void Image::createThisImage(
 	uint32_t arrayLayers,
 	VkSampleCountFlagBits sampleCount,
 	VkImageUsageFlags usage,
-	bool cubeMap)
+	bool cubeMap,
+	const std::vector<uint32_t> &queueFamilyIndices)
 {
 	this->device = device;
     this->format = format;
@@ -564,6 +599,7 @@ void Image::createThisImage(
 	this->arrayLayers = arrayLayers;
     this->sampleCount = sampleCount;
     this->cubeMap = cubeMap;
+    this->concurrent = !queueFamilyIndices.empty();
 
 	VkImageType imageType = VK_IMAGE_TYPE_1D;
 	if (extent.height > 0)
@@ -590,34 +626,60 @@ void Image::createThisImage(
 		sampleCount,
 		VK_IMAGE_TILING_OPTIMAL,
 		usage,
-		VK_SHARING_MODE_EXCLUSIVE,
-		0,
-		nullptr,
+		concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+		uint32_t(queueFamilyIndices.size()),
+		queueFamilyIndices.data(),
 		VK_IMAGE_LAYOUT_UNDEFINED
 	};
 
 	CALL_VK(vkCreateImage(device->get(), &imageInfo, nullptr, &image));
 
-	allocateMemory();
+	// memory of sparse image is bound by its owner
+	if (flags & VK_IMAGE_CREATE_SPARSE_BINDING_BIT)
+	{
+		return;
+	}
+
+	allocateMemory(usage);
 
-	vkBindImageMemory(device->get(), image, memory, 0);
+	vkBindImageMemory(device->get(), image, memory.memory, memory.offset);
 }
 
-void Image::allocateMemory()
+void Image::allocateMemory(VkImageUsageFlags usage)
 {
 	VkMemoryRequirements memRequirements;
 	vkGetImageMemoryRequirements(device->get(), image, &memRequirements);
 
-    const uint32_t memoryTypeIndex = device->findMemoryTypeIndex(
-		memRequirements.memoryTypeBits,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	// attachments are large and recreated with swapchain, so they don't fragment blocks of textures
+	const VkImageUsageFlags attachmentUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+		| VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+		| VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
 
-	VkMemoryAllocateInfo allocInfo{
-		VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-		nullptr,			
-		memRequirements.size,	
-		memoryTypeIndex,		
-	};
+	const bool attachment = usage & attachmentUsage;
+
+	// transient attachments can be backed only by tile memory (memory type is available on tilers)
+	const VkMemoryPropertyFlags preferredProperties = usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
+		? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT
+		: 0;
+
+	memory = device->getMemoryAllocator()->allocate(
+		memRequirements,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		preferredProperties,
+		attachment ? MemoryAllocator::STRATEGY_DEDICATED : MemoryAllocator::STRATEGY_LINEAR,
+		attachment ? MemoryAllocator::CATEGORY_ATTACHMENT : MemoryAllocator::CATEGORY_TEXTURE);
+}
 
-    CALL_VK(vkAllocateMemory(device->get(), &allocInfo, nullptr, &memory));
+void Image::releaseStagingBuffer(StagingBuffer *stagingBuffer) const
+{
+	// batched copy is executed later, so staging buffer must live until flush
+	UploadContext *uploadContext = device->getUploadContext();
+	if (uploadContext)
+	{
+		uploadContext->keep(stagingBuffer);
+	}
+	else
+	{
+		delete stagingBuffer;
+	}
 }
@@ -3,6 +3,9 @@
 #include "Device.h"
 #include <array>
 #include "DescriptorInfo.h"
+#include "MemoryAllocator.h"
+
+class StagingBuffer;
 
 class Image
 {
@@ -37,12 +40,16 @@ public:
 
     VkSampleCountFlagBits getSampleCount() const;
 
+    // image is shared by several queue families without ownership transfers
+    bool isConcurrent() const;
+
     DescriptorInfo getStorageImageInfo(uint32_t viewIndex = 0) const;
 
     void pushView(VkImageViewType viewType, VkImageSubresourceRange subresourceRange);
 
     void pushFullView(VkImageAspectFlags aspectFlags);
 
+    // queue family indices are used for ownership transfer (release and acquire barriers)
     void memoryBarrier(
         VkCommandBuffer commandBuffer,
         VkImageLayout oldLayout,
@@ -51,6 +58,16 @@ public:
         VkAccessFlags dstAccessMask,
         VkPipelineStageFlags srcStageMask,
         VkPipelineStageFlags dstStageMask,
+        VkImageSubresourceRange subresourceRange,
+        uint32_t srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        uint32_t dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED);
+
+    void transitLayout(
+        VkCommandBuffer commandBuffer,
+        VkImageLayout oldLayout,
+        VkImageLayout newLayout,
+        VkPipelineStageFlags srcStageMask,
+        VkPipelineStageFlags dstStageMask,
         VkImageSubresourceRange subresourceRange);
 
 	void transitLayout(
@@ -60,7 +77,15 @@ public:
         VkPipelineStageFlags dstStageMask,
         VkImageSubresourceRange subresourceRange);
 
-	void updateData(std::vector<const void*>, uint32_t layersOffset, uint32_t pixelSize);
+    // records transition of all mip levels to TRANSFER_DST and copying of layers to the first mip level,
+    // returned staging buffer must live until commands are completed (see releaseStagingBuffer)
+    StagingBuffer* updateData(
+        VkCommandBuffer commandBuffer,
+        const std::vector<const void*> &data,
+        uint32_t layersOffset,
+        uint32_t pixelSize);
+
+	void updateData(const std::vector<const void*> &data, uint32_t layersOffset, uint32_t pixelSize);
 
     void blitTo(
         VkCommandBuffer commandBuffer,
@@ -128,6 +153,7 @@ protected:
 
     std::vector<VkImageView> views;
 
+	// queueFamilyIndices - families which share image concurrently (at least two), empty - exclusive sharing
 	void createThisImage(
 		Device* device,
 		VkImageCreateFlags flags,
@@ -137,15 +163,22 @@ protected:
 		uint32_t arrayLayers,
 		VkSampleCountFlagBits sampleCount,
 		VkImageUsageFlags usage,
-		bool cubeMap);
+		bool cubeMap,
+		const std::vector<uint32_t> &queueFamilyIndices = {});
 
 private:
-	VkDeviceMemory memory;
+	MemoryAllocator::Allocation memory{};
 
     bool swapChainImage;
 
     bool cubeMap;
 
-	void allocateMemory();
+    bool concurrent = false;
+
+	void allocateMemory(VkImageUsageFlags usage);
+
+protected:
+    // destroys staging buffer after submission of one time commands which used it
+    void releaseStagingBuffer(StagingBuffer *stagingBuffer) const;
 };
 
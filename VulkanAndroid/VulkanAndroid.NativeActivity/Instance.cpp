@@ -22,6 +22,12 @@ Instance::Instance()
 
 	LOGA(checkExtensionsSupport(extensions));
 
+	// optional, required by device extensions such as timeline semaphores
+	if (checkExtensionsSupport({ VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME }))
+	{
+		extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+	}
+
 	createInstance();
 
 	if (validationEnabled)
@@ -0,0 +1,114 @@
+#include "Ktx2File.h"
+#include <algorithm>
+
+namespace
+{
+    // offsets of header fields (KTX 2.0 specification)
+    const size_t FORMAT_OFFSET = 12;
+    const size_t WIDTH_OFFSET = 20;
+    const size_t HEIGHT_OFFSET = 24;
+    const size_t DEPTH_OFFSET = 28;
+    const size_t LAYER_COUNT_OFFSET = 32;
+    const size_t FACE_COUNT_OFFSET = 36;
+    const size_t LEVEL_COUNT_OFFSET = 40;
+    const size_t SUPERCOMPRESSION_OFFSET = 44;
+    const size_t LEVEL_INDEX_OFFSET = 80;
+
+    // byteOffset, byteLength and uncompressedByteLength
+    const size_t LEVEL_INDEX_ENTRY_SIZE = 3 * sizeof(uint64_t);
+}
+
+const std::array<uint8_t, 12> Ktx2File::IDENTIFIER{
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+
+Ktx2File::Ktx2File(const uint8_t *data, size_t size) : data(data), size(size)
+{
+    LOGA(isKtx2(data, size));
+
+    format = VkFormat(read<uint32_t>(FORMAT_OFFSET));
+    extent = VkExtent3D{
+        read<uint32_t>(WIDTH_OFFSET),
+        (std::max)(read<uint32_t>(HEIGHT_OFFSET), 1u),
+        (std::max)(read<uint32_t>(DEPTH_OFFSET), 1u)
+    };
+    faceCount = read<uint32_t>(FACE_COUNT_OFFSET);
+    layerCount = (std::max)(read<uint32_t>(LAYER_COUNT_OFFSET), 1u) * faceCount;
+    mipLevelCount = read<uint32_t>(LEVEL_COUNT_OFFSET);
+
+    LOGA(format != VK_FORMAT_UNDEFINED);
+    LOGA(read<uint32_t>(SUPERCOMPRESSION_OFFSET) == 0);
+
+    // level index has one entry even if levels must be generated
+    const uint32_t storedLevelCount = (std::max)(mipLevelCount, 1u);
+    levels.resize(storedLevelCount);
+    for (uint32_t i = 0; i < storedLevelCount; i++)
+    {
+        const size_t entryOffset = LEVEL_INDEX_OFFSET + i * LEVEL_INDEX_ENTRY_SIZE;
+        levels[i] = Level{
+            read<uint64_t>(entryOffset),
+            read<uint64_t>(entryOffset + sizeof(uint64_t))
+        };
+
+        LOGA(levels[i].offset + levels[i].size <= size);
+    }
+}
+
+bool Ktx2File::isKtx2(const uint8_t *data, size_t size)
+{
+    return size >= LEVEL_INDEX_OFFSET + LEVEL_INDEX_ENTRY_SIZE
+        && std::equal(IDENTIFIER.begin(), IDENTIFIER.end(), data);
+}
+
+const uint8_t* Ktx2File::getData() const
+{
+    return data;
+}
+
+VkFormat Ktx2File::getFormat() const
+{
+    return format;
+}
+
+bool Ktx2File::isBlockCompressed() const
+{
+    // compressed formats of Vulkan 1.0 are declared one after another
+    return format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK;
+}
+
+VkExtent3D Ktx2File::getExtent() const
+{
+    return extent;
+}
+
+uint32_t Ktx2File::getLayerCount() const
+{
+    return layerCount;
+}
+
+uint32_t Ktx2File::getFaceCount() const
+{
+    return faceCount;
+}
+
+uint32_t Ktx2File::getMipLevelCount() const
+{
+    return mipLevelCount;
+}
+
+Ktx2File::Level Ktx2File::getLevel(uint32_t index) const
+{
+    return levels[index];
+}
+
+template<class T>
+T Ktx2File::read(size_t offset) const
+{
+    LOGA(offset + sizeof(T) <= size);
+
+    // fields are little endian as all supported devices
+    T value;
+    memcpy(&value, data + offset, sizeof(T));
+
+    return value;
+}
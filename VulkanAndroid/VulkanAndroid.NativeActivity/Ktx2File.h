@@ -0,0 +1,64 @@
+#pragma once
+#include <array>
+
+// view of texture in KTX 2.0 container with pre-generated mip levels,
+// only textures without supercompression are supported;
+// data isn't copied, so file (see AssetView) must outlive this object
+class Ktx2File
+{
+public:
+    struct Level
+    {
+        // offset of level data from the beginning of file
+        VkDeviceSize offset;
+        VkDeviceSize size;
+    };
+
+    Ktx2File(const uint8_t *data, size_t size);
+
+    // checks KTX 2.0 identifier
+    static bool isKtx2(const uint8_t *data, size_t size);
+
+    const uint8_t* getData() const;
+
+    VkFormat getFormat() const;
+
+    // format is block-compressed (BC, ETC2, EAC or ASTC), so levels can't be generated by blitting
+    bool isBlockCompressed() const;
+
+    VkExtent3D getExtent() const;
+
+    // total number of layers (array layers * faces)
+    uint32_t getLayerCount() const;
+
+    uint32_t getFaceCount() const;
+
+    // 0 means that mip levels must be generated at runtime
+    uint32_t getMipLevelCount() const;
+
+    // data of level contains all layers and faces one after another
+    Level getLevel(uint32_t index) const;
+
+private:
+    static const std::array<uint8_t, 12> IDENTIFIER;
+
+    const uint8_t *data;
+
+    size_t size;
+
+    VkFormat format;
+
+    VkExtent3D extent;
+
+    uint32_t layerCount;
+
+    uint32_t faceCount;
+
+    uint32_t mipLevelCount;
+
+    std::vector<Level> levels;
+
+    template<class T>
+    T read(size_t offset) const;
+};
+
@@ -1,23 +1,21 @@
 #include "Lighting.h"
 
-Lighting::Lighting(Device *device, Attributes attributes) : attributes(attributes)
+Lighting::Lighting(RingBuffer *uniformBuffer, Attributes attributes)
+    : attributes(attributes),
+      uniformBuffer(uniformBuffer)
 {
-    buffer = new Buffer(device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(Attributes));
-    buffer->updateData(&attributes);
+    bufferOffset = uniformBuffer->allocate(sizeof(Attributes));
 }
 
-Lighting::~Lighting()
-{
-    delete buffer;
-}
+Lighting::~Lighting() = default;
 
-Buffer* Lighting::getBuffer() const
+DescriptorInfo Lighting::getBufferInfo() const
 {
-    return buffer;
+    return uniformBuffer->getUniformBufferInfo(bufferOffset, sizeof(Attributes));
 }
 
 void Lighting::update(glm::vec3 cameraPos)
 {
     attributes.cameraPos = cameraPos;
-    buffer->updateData(&cameraPos, offsetof(Attributes, cameraPos), sizeof(glm::vec3));
+    uniformBuffer->updateData(&attributes, bufferOffset, sizeof(Attributes));
 }
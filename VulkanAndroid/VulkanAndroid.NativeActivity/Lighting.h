@@ -1,6 +1,6 @@
 #pragma once
 #include "Device.h"
-#include "Buffer.h"
+#include "RingBuffer.h"
 
 class Lighting
 {
@@ -14,17 +14,20 @@ public:
         float ambientIntensity;
     };
 
-    Lighting(Device *device, Attributes attributes);
+    Lighting(RingBuffer *uniformBuffer, Attributes attributes);
 
     ~Lighting();
 
-    Buffer* getBuffer() const;
+    DescriptorInfo getBufferInfo() const;
 
+    // writes attributes to current frame of uniform buffer
     void update(glm::vec3 cameraPos);
 
 private:
     Attributes attributes;
 
-    Buffer *buffer;
+    RingBuffer *uniformBuffer;
+
+    VkDeviceSize bufferOffset;
 };
 
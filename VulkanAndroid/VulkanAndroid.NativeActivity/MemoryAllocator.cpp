@@ -0,0 +1,509 @@
+#include "MemoryAllocator.h"
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+struct MemoryAllocator::Block
+{
+    struct Range
+    {
+        VkDeviceSize offset;
+        VkDeviceSize size;
+    };
+
+    VkDeviceMemory memory;
+    VkDeviceSize size;
+    uint8_t *mappedData;
+    uint32_t memoryTypeIndex;
+    Strategy strategy;
+    uint32_t allocationCount;
+    VkDeviceSize usedSize;
+
+    // linear strategy: end of the last allocation
+    VkDeviceSize head;
+
+    // free list strategy: free ranges sorted by offset
+    std::vector<Range> freeRanges;
+};
+
+MemoryAllocator::MemoryAllocator(Device *device) : device(device)
+{
+    memoryProperties = device->getMemoryProperties();
+
+    // linear and optimal resources can be neighbours in block
+    granularity = device->getLimits().bufferImageGranularity;
+
+    pools.resize(memoryProperties.memoryTypeCount * STRATEGY_COUNT);
+
+    categoryStats.resize(CATEGORY_COUNT, CategoryStats{});
+    heapReservedSizes.resize(memoryProperties.memoryHeapCount, 0);
+    heapPeakReservedSizes.resize(memoryProperties.memoryHeapCount, 0);
+}
+
+MemoryAllocator::~MemoryAllocator()
+{
+    const Stats stats = getStats();
+    if (stats.allocationCount > 0)
+    {
+        LOGE("Memory allocations aren't freed: %d.", stats.allocationCount);
+    }
+
+    for (auto &pool : pools)
+    {
+        for (auto block : pool)
+        {
+            destroyBlock(block);
+        }
+    }
+
+    logStats();
+}
+
+MemoryAllocator::Allocation MemoryAllocator::allocate(
+    VkMemoryRequirements requirements,
+    VkMemoryPropertyFlags properties,
+    VkMemoryPropertyFlags preferredProperties,
+    Strategy strategy,
+    Category category)
+{
+    const uint32_t memoryTypeIndex = device->findMemoryTypeIndex(
+        requirements.memoryTypeBits,
+        properties,
+        preferredProperties);
+
+    const bool lazy = isLazilyAllocated(memoryTypeIndex);
+
+    if (strategy == STRATEGY_DEDICATED || requirements.size > BLOCK_SIZE / 2 || lazy)
+    {
+        Allocation allocation{};
+        allocation.memory = allocateMemory(requirements.size, memoryTypeIndex, &allocation.mappedData);
+        allocation.size = requirements.size;
+        allocation.memoryTypeIndex = memoryTypeIndex;
+        allocation.category = category;
+
+        dedicatedAllocationCount++;
+        dedicatedSize += requirements.size;
+        addUsedSize(category, requirements.size);
+
+        if (lazy)
+        {
+            lazyAllocationCount++;
+            lazySize += requirements.size;
+            LOGI("Lazily allocated memory: %llu KB, type %d.",
+                static_cast<unsigned long long>(requirements.size / 1024),
+                memoryTypeIndex);
+        }
+
+        return allocation;
+    }
+
+    const VkDeviceSize alignment = (std::max)(requirements.alignment, granularity);
+    const VkDeviceSize size = alignSize(requirements.size, alignment);
+
+    auto &pool = pools[memoryTypeIndex * STRATEGY_COUNT + strategy];
+
+    VkDeviceSize offset;
+    Block *block = nullptr;
+    for (auto poolBlock : pool)
+    {
+        if (subAllocate(poolBlock, size, alignment, &offset))
+        {
+            block = poolBlock;
+            break;
+        }
+    }
+
+    if (!block)
+    {
+        block = createBlock(memoryTypeIndex, strategy);
+        pool.push_back(block);
+
+        const bool allocated = subAllocate(block, size, alignment, &offset);
+        LOGA(allocated);
+    }
+
+    block->allocationCount++;
+    block->usedSize += size;
+    addUsedSize(category, size);
+
+    return Allocation{
+        block->memory,
+        offset,
+        size,
+        block->mappedData ? block->mappedData + offset : nullptr,
+        block,
+        memoryTypeIndex,
+        category
+    };
+}
+
+void MemoryAllocator::free(const Allocation &allocation)
+{
+    if (!allocation.block)
+    {
+        if (allocation.memory)
+        {
+            freeMemory(allocation.memory, allocation.size, allocation.memoryTypeIndex);
+
+            dedicatedAllocationCount--;
+            dedicatedSize -= allocation.size;
+            removeUsedSize(allocation.category, allocation.size);
+
+            if (isLazilyAllocated(allocation.memoryTypeIndex))
+            {
+                lazyAllocationCount--;
+                lazySize -= allocation.size;
+            }
+        }
+        return;
+    }
+
+    Block *block = allocation.block;
+
+    LOGA(block->allocationCount > 0);
+
+    block->allocationCount--;
+    block->usedSize -= allocation.size;
+    removeUsedSize(allocation.category, allocation.size);
+
+    if (block->strategy == STRATEGY_FREE_LIST)
+    {
+        freeRange(block, allocation.offset, allocation.size);
+    }
+
+    // empty blocks are returned to driver
+    if (block->allocationCount == 0)
+    {
+        auto &pool = pools[block->memoryTypeIndex * STRATEGY_COUNT + block->strategy];
+        pool.erase(std::find(pool.begin(), pool.end(), block));
+
+        destroyBlock(block);
+    }
+}
+
+MemoryAllocator::Stats MemoryAllocator::getStats() const
+{
+    Stats stats{
+        dedicatedAllocationCount,
+        dedicatedAllocationCount,
+        dedicatedSize,
+        dedicatedSize,
+        0,
+        0,
+        0.0f,
+        peakReservedSize,
+        peakUsedSize,
+        lazyAllocationCount,
+        lazySize
+    };
+
+    VkDeviceSize freeSize = 0;
+
+    for (const auto &pool : pools)
+    {
+        for (auto block : pool)
+        {
+            stats.deviceAllocationCount++;
+            stats.allocationCount += block->allocationCount;
+            stats.reservedSize += block->size;
+            stats.usedSize += block->usedSize;
+
+            if (block->strategy == STRATEGY_LINEAR)
+            {
+                // freed allocations before head aren't reused until block is empty
+                const VkDeviceSize tail = block->size - block->head;
+                stats.freeRangeCount += tail > 0 ? 1 : 0;
+                stats.largestFreeRange = (std::max)(stats.largestFreeRange, tail);
+                freeSize += tail;
+            }
+            else
+            {
+                for (const auto &range : block->freeRanges)
+                {
+                    stats.freeRangeCount++;
+                    stats.largestFreeRange = (std::max)(stats.largestFreeRange, range.size);
+                    freeSize += range.size;
+                }
+            }
+        }
+    }
+
+    if (freeSize > 0)
+    {
+        stats.fragmentation = 1.0f - float(stats.largestFreeRange) / float(freeSize);
+    }
+
+    return stats;
+}
+
+MemoryAllocator::CategoryStats MemoryAllocator::getCategoryStats(Category category) const
+{
+    return categoryStats[category];
+}
+
+std::vector<MemoryAllocator::HeapStats> MemoryAllocator::getHeapStats() const
+{
+    std::vector<HeapStats> heapStats(memoryProperties.memoryHeapCount);
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget{};
+    if (device->memoryBudgetEnabled())
+    {
+        budget = device->getMemoryBudget();
+    }
+
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+    {
+        const VkMemoryHeap &heap = memoryProperties.memoryHeaps[i];
+
+        heapStats[i] = HeapStats{
+            heap.flags,
+            heap.size,
+            heapReservedSizes[i],
+            heapPeakReservedSizes[i],
+            device->memoryBudgetEnabled() ? budget.heapUsage[i] : heapReservedSizes[i],
+            device->memoryBudgetEnabled() ? budget.heapBudget[i] : heap.size
+        };
+    }
+
+    return heapStats;
+}
+
+std::string MemoryAllocator::getReport() const
+{
+    static const char *CATEGORY_NAMES[CATEGORY_COUNT]{
+        "textures",
+        "attachments",
+        "vertex/index",
+        "uniform",
+        "staging"
+    };
+
+    const auto toKb = [](VkDeviceSize size)
+    {
+        return static_cast<unsigned long long>(size / 1024);
+    };
+
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(2);
+
+    const Stats stats = getStats();
+    report << "Device memory: "
+        << stats.allocationCount << " allocations in "
+        << stats.deviceAllocationCount << " device allocations, used "
+        << toKb(stats.usedSize) << " KB (peak " << toKb(stats.peakUsedSize) << " KB), reserved "
+        << toKb(stats.reservedSize) << " KB (peak " << toKb(stats.peakReservedSize) << " KB), fragmentation "
+        << stats.fragmentation << "\n";
+
+    report << "Lazily allocated: " << stats.lazyAllocationCount << " allocations, "
+        << toKb(stats.lazySize) << " KB"
+        << (stats.lazyAllocationCount > 0 ? "" : " (transient attachments use regular memory)") << "\n";
+
+    for (uint32_t i = 0; i < CATEGORY_COUNT; i++)
+    {
+        const CategoryStats &category = categoryStats[i];
+        report << "Category " << CATEGORY_NAMES[i] << ": "
+            << category.allocationCount << " allocations, "
+            << toKb(category.size) << " KB (peak " << toKb(category.peakSize) << " KB)\n";
+    }
+
+    const std::vector<HeapStats> heapStats = getHeapStats();
+    for (uint32_t i = 0; i < heapStats.size(); i++)
+    {
+        const HeapStats &heap = heapStats[i];
+        report << "Heap " << i << (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT ? " (device local)" : "") << ": "
+            << "reserved " << toKb(heap.reservedSize) << " KB (peak " << toKb(heap.peakReservedSize) << " KB), "
+            << "usage " << toKb(heap.usage) << " KB, budget " << toKb(heap.budget) << " KB, "
+            << "size " << toKb(heap.size) << " KB"
+            << (device->memoryBudgetEnabled() ? "" : " (no budget extension)") << "\n";
+    }
+
+    return report.str();
+}
+
+void MemoryAllocator::logStats() const
+{
+    std::istringstream report(getReport());
+
+    std::string line;
+    while (std::getline(report, line))
+    {
+        LOGI("%s", line.c_str());
+    }
+}
+
+VkDeviceMemory MemoryAllocator::allocateMemory(
+    VkDeviceSize size,
+    uint32_t memoryTypeIndex,
+    uint8_t **outMappedData)
+{
+    VkDeviceMemory memory;
+
+    VkMemoryAllocateInfo allocInfo{
+        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        nullptr,
+        size,
+        memoryTypeIndex,
+    };
+
+    CALL_VK(vkAllocateMemory(device->get(), &allocInfo, nullptr, &memory));
+
+    const uint32_t heapIndex = memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+    heapReservedSizes[heapIndex] += size;
+    heapPeakReservedSizes[heapIndex] = (std::max)(heapPeakReservedSizes[heapIndex], heapReservedSizes[heapIndex]);
+
+    reservedSize += size;
+    peakReservedSize = (std::max)(peakReservedSize, reservedSize);
+
+    *outMappedData = nullptr;
+
+    // memory can be mapped only once, so it's mapped for whole lifetime
+    if (memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        void *data;
+        CALL_VK(vkMapMemory(device->get(), memory, 0, VK_WHOLE_SIZE, 0, &data));
+        *outMappedData = reinterpret_cast<uint8_t*>(data);
+    }
+
+    return memory;
+}
+
+void MemoryAllocator::freeMemory(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex)
+{
+    vkFreeMemory(device->get(), memory, nullptr);
+
+    heapReservedSizes[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex] -= size;
+    reservedSize -= size;
+}
+
+void MemoryAllocator::addUsedSize(Category category, VkDeviceSize size)
+{
+    CategoryStats &stats = categoryStats[category];
+    stats.allocationCount++;
+    stats.size += size;
+    stats.peakSize = (std::max)(stats.peakSize, stats.size);
+
+    usedSize += size;
+    peakUsedSize = (std::max)(peakUsedSize, usedSize);
+}
+
+void MemoryAllocator::removeUsedSize(Category category, VkDeviceSize size)
+{
+    CategoryStats &stats = categoryStats[category];
+    stats.allocationCount--;
+    stats.size -= size;
+
+    usedSize -= size;
+}
+
+MemoryAllocator::Block* MemoryAllocator::createBlock(uint32_t memoryTypeIndex, Strategy strategy)
+{
+    auto block = new Block{};
+    block->memory = allocateMemory(BLOCK_SIZE, memoryTypeIndex, &block->mappedData);
+    block->size = BLOCK_SIZE;
+    block->memoryTypeIndex = memoryTypeIndex;
+    block->strategy = strategy;
+
+    if (strategy == STRATEGY_FREE_LIST)
+    {
+        block->freeRanges.push_back(Block::Range{ 0, BLOCK_SIZE });
+    }
+
+    LOGD("Memory block created: type %d, strategy %d.", memoryTypeIndex, strategy);
+
+    return block;
+}
+
+void MemoryAllocator::destroyBlock(Block *block)
+{
+    freeMemory(block->memory, block->size, block->memoryTypeIndex);
+
+    delete block;
+}
+
+bool MemoryAllocator::isLazilyAllocated(uint32_t memoryTypeIndex) const
+{
+    return memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+}
+
+bool MemoryAllocator::subAllocate(Block *block, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize *outOffset)
+{
+    if (block->strategy == STRATEGY_LINEAR)
+    {
+        const VkDeviceSize offset = alignSize(block->head, alignment);
+        if (offset + size > block->size)
+        {
+            return false;
+        }
+
+        block->head = offset + size;
+        *outOffset = offset;
+
+        return true;
+    }
+
+    for (auto it = block->freeRanges.begin(); it != block->freeRanges.end(); ++it)
+    {
+        const VkDeviceSize offset = alignSize(it->offset, alignment);
+        const VkDeviceSize rangeEnd = it->offset + it->size;
+        if (offset + size > rangeEnd)
+        {
+            continue;
+        }
+
+        // alignment padding stays free before allocation
+        const Block::Range before{ it->offset, offset - it->offset };
+        const Block::Range after{ offset + size, rangeEnd - (offset + size) };
+
+        it = block->freeRanges.erase(it);
+        if (after.size > 0)
+        {
+            it = block->freeRanges.insert(it, after);
+        }
+        if (before.size > 0)
+        {
+            block->freeRanges.insert(it, before);
+        }
+
+        *outOffset = offset;
+
+        return true;
+    }
+
+    return false;
+}
+
+void MemoryAllocator::freeRange(Block *block, VkDeviceSize offset, VkDeviceSize size)
+{
+    auto &ranges = block->freeRanges;
+
+    auto it = std::lower_bound(ranges.begin(), ranges.end(), offset, [](const Block::Range &range, VkDeviceSize offset)
+    {
+        return range.offset < offset;
+    });
+
+    it = ranges.insert(it, Block::Range{ offset, size });
+
+    // merge with next range
+    const auto next = it + 1;
+    if (next != ranges.end() && it->offset + it->size == next->offset)
+    {
+        it->size += next->size;
+        it = ranges.erase(next) - 1;
+    }
+
+    // merge with previous range
+    if (it != ranges.begin())
+    {
+        const auto previous = it - 1;
+        if (previous->offset + previous->size == it->offset)
+        {
+            previous->size += it->size;
+            ranges.erase(it);
+        }
+    }
+}
+
+VkDeviceSize MemoryAllocator::alignSize(VkDeviceSize size, VkDeviceSize alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
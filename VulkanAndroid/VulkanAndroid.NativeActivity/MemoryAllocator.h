@@ -0,0 +1,165 @@
+#pragma once
+#include "Device.h"
+
+// allocates device memory by large blocks (pool of blocks for each memory type)
+// and sub-allocates resources from them, host visible blocks are persistently mapped
+class MemoryAllocator
+{
+public:
+    enum Strategy
+    {
+        // long-lived resources: bump allocation, block is reused when all its allocations are freed
+        STRATEGY_LINEAR,
+        // resources which are freed in any order: first fit in list of free ranges
+        STRATEGY_FREE_LIST,
+        // own device memory (large attachments and resources larger than half of block),
+        // lazily allocated memory is always dedicated
+        STRATEGY_DEDICATED,
+        STRATEGY_COUNT
+    };
+
+    // purpose of memory for accounting
+    enum Category
+    {
+        CATEGORY_TEXTURE,
+        CATEGORY_ATTACHMENT,
+        CATEGORY_VERTEX_INDEX,
+        CATEGORY_UNIFORM,
+        CATEGORY_STAGING,
+        CATEGORY_COUNT
+    };
+
+    struct Block;
+
+    struct Allocation
+    {
+        VkDeviceMemory memory;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        // nullptr if memory isn't host visible
+        uint8_t *mappedData;
+        // nullptr for dedicated allocations
+        Block *block;
+        uint32_t memoryTypeIndex;
+        Category category;
+    };
+
+    struct Stats
+    {
+        // number of vkAllocateMemory objects (limited by maxMemoryAllocationCount)
+        uint32_t deviceAllocationCount;
+        uint32_t allocationCount;
+        VkDeviceSize reservedSize;
+        VkDeviceSize usedSize;
+        uint32_t freeRangeCount;
+        VkDeviceSize largestFreeRange;
+        // 0 - free memory of blocks is contiguous, close to 1 - free memory is split into small ranges
+        float fragmentation;
+        // high-water marks since creation of allocator
+        VkDeviceSize peakReservedSize;
+        VkDeviceSize peakUsedSize;
+        // transient attachments with lazily allocated memory (may have no physical memory on tilers)
+        uint32_t lazyAllocationCount;
+        VkDeviceSize lazySize;
+    };
+
+    struct CategoryStats
+    {
+        uint32_t allocationCount;
+        VkDeviceSize size;
+        VkDeviceSize peakSize;
+    };
+
+    struct HeapStats
+    {
+        VkMemoryHeapFlags flags;
+        VkDeviceSize size;
+        // device memory allocated by this allocator
+        VkDeviceSize reservedSize;
+        VkDeviceSize peakReservedSize;
+        // usage of heap by whole process and memory available to process,
+        // without VK_EXT_memory_budget these are reserved size and heap size
+        VkDeviceSize usage;
+        VkDeviceSize budget;
+    };
+
+    MemoryAllocator(Device *device);
+
+    ~MemoryAllocator();
+
+    Allocation allocate(
+        VkMemoryRequirements requirements,
+        VkMemoryPropertyFlags properties,
+        VkMemoryPropertyFlags preferredProperties,
+        Strategy strategy,
+        Category category);
+
+    void free(const Allocation &allocation);
+
+    Stats getStats() const;
+
+    CategoryStats getCategoryStats(Category category) const;
+
+    std::vector<HeapStats> getHeapStats() const;
+
+    // human-readable report of all stats (one line per entry)
+    std::string getReport() const;
+
+    void logStats() const;
+
+private:
+    const VkDeviceSize BLOCK_SIZE = 16 * 1024 * 1024;
+
+    Device *device;
+
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+
+    VkDeviceSize granularity;
+
+    // blocks for each memory type and sub-allocation strategy
+    std::vector<std::vector<Block*>> pools;
+
+    uint32_t dedicatedAllocationCount = 0;
+
+    VkDeviceSize dedicatedSize = 0;
+
+    uint32_t lazyAllocationCount = 0;
+
+    VkDeviceSize lazySize = 0;
+
+    std::vector<CategoryStats> categoryStats;
+
+    // indexed by memory heap
+    std::vector<VkDeviceSize> heapReservedSizes;
+
+    std::vector<VkDeviceSize> heapPeakReservedSizes;
+
+    VkDeviceSize reservedSize = 0;
+
+    VkDeviceSize peakReservedSize = 0;
+
+    VkDeviceSize usedSize = 0;
+
+    VkDeviceSize peakUsedSize = 0;
+
+    VkDeviceMemory allocateMemory(VkDeviceSize size, uint32_t memoryTypeIndex, uint8_t **outMappedData);
+
+    void freeMemory(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex);
+
+    void addUsedSize(Category category, VkDeviceSize size);
+
+    void removeUsedSize(Category category, VkDeviceSize size);
+
+    Block* createBlock(uint32_t memoryTypeIndex, Strategy strategy);
+
+    void destroyBlock(Block *block);
+
+    bool isLazilyAllocated(uint32_t memoryTypeIndex) const;
+
+    static bool subAllocate(Block *block, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize *outOffset);
+
+    static void freeRange(Block *block, VkDeviceSize offset, VkDeviceSize size);
+
+    static VkDeviceSize alignSize(VkDeviceSize size, VkDeviceSize alignment);
+};
+
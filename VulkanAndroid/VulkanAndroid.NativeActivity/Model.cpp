@@ -1,14 +1,11 @@
 #include "Model.h"
 #include <glm/gtx/transform.hpp>
 
-Model::~Model()
-{
-    delete transformationBuffer;
-}
+Model::~Model() = default;
 
 DescriptorInfo Model::getTransformationBufferInfo() const
 {
-    return transformationBuffer->getUniformBufferInfo();
+    return uniformBuffer->getUniformBufferInfo(transformationOffset, sizeof(glm::mat4));
 }
 
 glm::mat4 Model::getTransformation() const
@@ -19,11 +16,14 @@ glm::mat4 Model::getTransformation() const
 void Model::setTransformation(glm::mat4 transformation)
 {
     this->transformation = transformation;
-    transformationBuffer->updateData(&transformation);
 }
 
-Model::Model(Device *device) : transformation(glm::mat4(1.0f))
+void Model::updateUniforms()
+{
+    uniformBuffer->updateData(&transformation, transformationOffset, sizeof(glm::mat4));
+}
+
+Model::Model(RingBuffer *uniformBuffer) : uniformBuffer(uniformBuffer), transformation(glm::mat4(1.0f))
 {
-    transformationBuffer = new Buffer(device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(glm::mat4));
-    transformationBuffer->updateData(&transformation);
+    transformationOffset = uniformBuffer->allocate(sizeof(glm::mat4));
 }
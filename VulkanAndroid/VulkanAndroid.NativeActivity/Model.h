@@ -1,5 +1,5 @@
 #pragma once
-#include "Buffer.h"
+#include "RingBuffer.h"
 #include "TextureImage.h"
 
 class Model
@@ -17,12 +17,17 @@ public:
 
     void setTransformation(glm::mat4 transformation);
 
+    // writes uniform data of model to current frame of uniform buffer
+    virtual void updateUniforms();
+
 protected:
-    Model(Device *device);
+    Model(RingBuffer *uniformBuffer);
+
+    RingBuffer *uniformBuffer;
 
 private:
     glm::mat4 transformation;
 
-    Buffer *transformationBuffer;
+    VkDeviceSize transformationOffset;
 };
 
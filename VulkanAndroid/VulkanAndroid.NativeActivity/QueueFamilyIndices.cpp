@@ -12,28 +12,50 @@ QueueFamilyIndices::QueueFamilyIndices(VkPhysicalDevice device, VkSurfaceKHR sur
 
 	for (uint32_t i = 0; i < queueFamilyCount; i++)
 	{
-		if (queueFamilies[i].queueCount > 0 && queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
+        if (queueFamilies[i].queueCount == 0)
+        {
+            continue;
+        }
+
+        const VkQueueFlags flags = queueFamilies[i].queueFlags;
+
+        // graphics family must support compute too, it is used as fallback for all other queues
+		if (graphics < 0 && flags & VK_QUEUE_GRAPHICS_BIT && flags & VK_QUEUE_COMPUTE_BIT)
 		{
 			graphics = i;
 		}
 
-        if (queueFamilies[i].queueCount > 0 && queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT)
+        // dedicated compute family allows async computing
+        if (compute < 0 && flags & VK_QUEUE_COMPUTE_BIT && !(flags & VK_QUEUE_GRAPHICS_BIT))
         {
             compute = i;
         }
 
+        // dedicated transfer family is usually served by DMA engine
+        if (transfer < 0 && flags & VK_QUEUE_TRANSFER_BIT && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+        {
+            transfer = i;
+        }
+
 		VkBool32 presentationSupport = false;
 		vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentationSupport);
-		if (queueFamilies[i].queueCount > 0 && presentationSupport)
+		// presentation from graphics family is preferred
+		if (presentationSupport && (presentation < 0 || int(i) == graphics))
 		{
             presentation = i;
 		}
-
-		if (completed())
-		{
-			break;
-		}
 	}
+
+    if (compute < 0)
+    {
+        compute = graphics;
+    }
+
+    // transfer operations are supported by all compute and graphics families
+    if (transfer < 0)
+    {
+        transfer = compute;
+    }
 }
 
 uint32_t QueueFamilyIndices::getGraphics() const
@@ -50,6 +72,13 @@ uint32_t QueueFamilyIndices::getCompute() const
     return uint32_t(compute);
 }
 
+uint32_t QueueFamilyIndices::getTransfer() const
+{
+    LOGA(transfer >= 0);
+
+    return uint32_t(transfer);
+}
+
 uint32_t QueueFamilyIndices::getPresentation() const
 {
     LOGA(presentation >= 0);
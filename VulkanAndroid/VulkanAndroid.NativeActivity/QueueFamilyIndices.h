@@ -8,8 +8,12 @@ public:
 
 	uint32_t getGraphics() const;
 
+    // dedicated compute family if it exists, otherwise graphics family
     uint32_t getCompute() const;
 
+    // dedicated transfer family if it exists, otherwise compute family
+    uint32_t getTransfer() const;
+
 	uint32_t getPresentation() const;
 
 	// this device have all required queue families (for this surface)
@@ -19,6 +23,7 @@ private:
 	// queue family indices
 	int graphics = -1;
     int compute = -1;
+    int transfer = -1;
 	int presentation = -1;
 };
 
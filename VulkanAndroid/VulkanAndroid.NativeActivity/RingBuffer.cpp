@@ -0,0 +1,74 @@
+#include "RingBuffer.h"
+
+RingBuffer::RingBuffer(Device *device, VkBufferUsageFlags usage, VkDeviceSize frameSize, uint32_t frameCount)
+    : StagingBuffer(
+        device,
+        alignSize(frameSize, device->getLimits().minUniformBufferOffsetAlignment) * frameCount,
+        usage,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        MemoryAllocator::CATEGORY_UNIFORM),
+      alignment(device->getLimits().minUniformBufferOffsetAlignment),
+      frameSize(alignSize(frameSize, alignment)),
+      frameCount(frameCount)
+{
+}
+
+uint32_t RingBuffer::getFrameCount() const
+{
+    return frameCount;
+}
+
+VkDeviceSize RingBuffer::allocate(VkDeviceSize regionSize)
+{
+    const VkDeviceSize offset = allocatedSize;
+
+    allocatedSize = alignSize(offset + regionSize, alignment);
+
+    LOGA(allocatedSize <= frameSize);
+
+    return offset;
+}
+
+void RingBuffer::setFrame(uint32_t index)
+{
+    LOGA(index < frameCount);
+
+    frameIndex = index;
+}
+
+DescriptorInfo RingBuffer::getUniformBufferInfo(VkDeviceSize offset, VkDeviceSize regionSize) const
+{
+    DescriptorInfo info;
+    info.buffer = VkDescriptorBufferInfo{
+        stagingBuffer,
+        offset,
+        regionSize
+    };
+
+    return info;
+}
+
+uint32_t RingBuffer::getDynamicOffset(uint32_t frameIndex) const
+{
+    LOGA(frameIndex < frameCount);
+
+    return uint32_t(frameIndex * frameSize);
+}
+
+void RingBuffer::updateData(const void *data, VkDeviceSize offset, VkDeviceSize dataSize)
+{
+    if (dataSize == VkDeviceSize(-1))
+    {
+        dataSize = frameSize - offset;
+    }
+
+    // data mustn't be written to part of the next frame
+    LOGA(offset <= frameSize && dataSize <= frameSize - offset);
+
+    memcpy(stagingMemory.mappedData + frameIndex * frameSize + offset, data, dataSize);
+}
+
+VkDeviceSize RingBuffer::alignSize(VkDeviceSize size, VkDeviceSize alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
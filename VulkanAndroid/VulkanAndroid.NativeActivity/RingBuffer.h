@@ -0,0 +1,43 @@
+#pragma once
+#include "StagingBuffer.h"
+#include "DescriptorInfo.h"
+
+// persistently mapped buffer divided into equal parts for each frame in flight,
+// data is written directly to the part of current frame without any submissions,
+// one descriptor set is shared by all frames and part is selected by dynamic offset,
+// device local memory is preferred (unified memory of integrated GPUs)
+class RingBuffer : public StagingBuffer
+{
+public:
+    RingBuffer(Device *device, VkBufferUsageFlags usage, VkDeviceSize frameSize, uint32_t frameCount);
+
+    uint32_t getFrameCount() const;
+
+    // reserves region in each frame part and returns offset of this region inside of frame part
+    VkDeviceSize allocate(VkDeviceSize regionSize);
+
+    void setFrame(uint32_t index);
+
+    // region of the first frame part, other frames are selected by dynamic offset
+    DescriptorInfo getUniformBufferInfo(VkDeviceSize offset, VkDeviceSize regionSize) const;
+
+    // dynamic offset which selects frame part for descriptors of UNIFORM_BUFFER_DYNAMIC type
+    uint32_t getDynamicOffset(uint32_t frameIndex) const;
+
+    // writes data to region of current frame, default size - the rest of frame part
+    void updateData(const void *data, VkDeviceSize offset = 0, VkDeviceSize dataSize = VkDeviceSize(-1)) override;
+
+private:
+    VkDeviceSize alignment;
+
+    VkDeviceSize frameSize;
+
+    uint32_t frameCount;
+
+    uint32_t frameIndex = 0;
+
+    VkDeviceSize allocatedSize = 0;
+
+    static VkDeviceSize alignSize(VkDeviceSize size, VkDeviceSize alignment);
+};
+
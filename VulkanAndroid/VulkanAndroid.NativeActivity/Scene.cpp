@@ -3,8 +3,11 @@
 #include "cube.h"
 #include "card.h"
 
-Scene::Scene(Device *device, VkExtent2D extent)
+Scene::Scene(Device *device, VkExtent2D extent, uint32_t frameCount, float idleFps)
+    : idleFrameInterval(idleFps > 0.0f ? 1.0f / idleFps : 0.0f)
 {
+    uniformBuffer = new RingBuffer(device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, UNIFORM_FRAME_SIZE, frameCount);
+
     const Camera::Parameters cameraParameters{
         extent,
         90.0f,
@@ -16,7 +19,7 @@ Scene::Scene(Device *device, VkExtent2D extent)
         glm::vec3(0.0f, 0.0f, 0.0f),
         glm::vec3(0.0f, -1.0f, 0.0f)
     };
-    camera = new Camera(device, cameraParameters, cameraLocation);
+    camera = new Camera(uniformBuffer, cameraParameters, cameraLocation);
 
     controller = new Controller(cameraLocation.target, cameraLocation.position);
 
@@ -27,13 +30,16 @@ Scene::Scene(Device *device, VkExtent2D extent)
         8.0f,
         0.02f,
     };
-    lighting = new Lighting(device, lightingAttributes);
+    lighting = new Lighting(uniformBuffer, lightingAttributes);
 
+    // all textures are decoded concurrently, uploads are done on this thread
+    TextureLoader textureLoader(device);
+    textureStreamer = new TextureStreamer(device);
 
-    earth = new Earth(device, "textures/earth/2K/");
-    clouds = new Clouds(device, "textures/earth/2K/");
-    skybox = new Skybox(device, "textures/Stars/");
-    gallery = new Gallery(device, "Gallery/", earth, camera, controller);
+    earth = new Earth(device, &textureLoader, textureStreamer, uniformBuffer, "textures/earth/2K/");
+    clouds = new Clouds(device, &textureLoader, textureStreamer, uniformBuffer, "textures/earth/2K/");
+    skybox = new Skybox(device, &textureLoader, uniformBuffer, "textures/Stars/");
+    gallery = new Gallery(device, &textureLoader, uniformBuffer, "Gallery/", earth, camera, controller);
 
     models.resize(uint32_t(ModelId::COUNT));
     models[uint32_t(ModelId::EARTH)] = earth;
@@ -43,11 +49,15 @@ Scene::Scene(Device *device, VkExtent2D extent)
 
     initMeshes(device);
 
+    textureLoader.finish();
+
     LOGI("Scene created.");
 }
 
 Scene::~Scene()
 {
+    delete textureStreamer;
+
     for (auto &buffer : meshBuffers)
     {
         delete buffer;
@@ -61,16 +71,17 @@ Scene::~Scene()
     delete lighting;
     delete controller;
     delete camera;
+    delete uniformBuffer;
 }
 
-Buffer* Scene::getCameraBuffer() const
+DescriptorInfo Scene::getCameraBufferInfo() const
 {
-    return camera->getBuffer();
+    return camera->getBufferInfo();
 }
 
 DescriptorInfo Scene::getLightingBufferInfo() const
 {
-    return lighting->getBuffer()->getUniformBufferInfo();
+    return lighting->getBufferInfo();
 }
 
 std::vector<DescriptorInfo> Scene::getModelTextureInfos(ModelId id)
@@ -88,14 +99,21 @@ DescriptorInfo Scene::getModelTransformationBufferInfo(ModelId id)
     return models[uint32_t(id)]->getTransformationBufferInfo();
 }
 
+uint32_t Scene::getUniformDynamicOffset(uint32_t frameIndex) const
+{
+    return uniformBuffer->getDynamicOffset(frameIndex);
+}
+
 void Scene::handleMotion(glm::vec2 delta)
 {
     controller->setMotionDelta(delta);
+    invalidate();
 }
 
 void Scene::handleZoom(float delta)
 {
     controller->setZoomDelta(delta);
+    invalidate();
 }
 
 void Scene::skipTime()
@@ -103,19 +121,45 @@ void Scene::skipTime()
     timer.getDeltaSec();
 }
 
-void Scene::update()
+void Scene::invalidate()
+{
+    dirty = true;
+}
+
+bool Scene::isRedrawRequired() const
+{
+    if (dirty || controller->isMoving())
+    {
+        return true;
+    }
+
+    // earth rotation with low rate
+    return idleFrameInterval > 0.0f && timer.getElapsedSec() >= idleFrameInterval;
+}
+
+void Scene::update(uint32_t frameIndex)
 {
     const float deltaSec = timer.getDeltaSec();
 
+    uniformBuffer->setFrame(frameIndex);
+
     controller->update(deltaSec);
     camera->update(controller->getLocation());
     lighting->update(camera->getPosition());
 
     earth->rotate(2.0f * deltaSec);
+    earth->requestTiles(camera->getPosition(), camera->getPixelAngle());
     clouds->setEarthTransformation(earth->getTransformation());
     skybox->setTransformation(translate(glm::mat4(1.0f), camera->getPosition()));
     gallery->update();
 
+    for (auto model : models)
+    {
+        model->updateUniforms();
+    }
+
+    dirty = false;
+
 #ifndef NDEBUG
     logFps(deltaSec);
 #endif
@@ -124,11 +168,35 @@ void Scene::update()
 void Scene::activateGallery()
 {
     gallery->activate();
+    invalidate();
 }
 
 void Scene::resize(VkExtent2D newExtent)
 {
     camera->resize(newExtent);
+    invalidate();
+}
+
+bool Scene::updateTextures()
+{
+    // tiles of virtual textures are visible without publishing
+    if (textureStreamer->updateTiles())
+    {
+        invalidate();
+    }
+
+    return textureStreamer->update();
+}
+
+void Scene::publishTextures(uint64_t frameNumber)
+{
+    textureStreamer->publish(frameNumber);
+    invalidate();
+}
+
+void Scene::releaseTextureViews(uint64_t completedFrameNumber)
+{
+    textureStreamer->releaseViews(completedFrameNumber);
 }
 
 void Scene::drawSphere(VkCommandBuffer commandBuffer) const
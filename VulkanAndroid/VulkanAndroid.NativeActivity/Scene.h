@@ -7,6 +7,8 @@
 #include "Skybox.h"
 #include "Clouds.h"
 #include "Gallery.h"
+#include "Buffer.h"
+#include "RingBuffer.h"
 
 class Scene
 {
@@ -20,14 +22,17 @@ public:
         COUNT,
     };
 
-    static const uint32_t BUFFER_COUNT = 7;
-    static const uint32_t TEXTURE_COUNT = EARTH_TEXTURE_TYPE_COUNT + 4;
+    static const uint32_t DYNAMIC_BUFFER_COUNT = 7;
+    // textures of earth and their LOD maps (see VirtualTexture)
+    static const uint32_t EARTH_TEXTURE_COUNT = 2 * EARTH_TEXTURE_TYPE_COUNT;
+    static const uint32_t TEXTURE_COUNT = EARTH_TEXTURE_COUNT + 4;
 
-    Scene(Device *device, VkExtent2D extent);
+    // idleFps - rate of redrawing when nothing but earth rotation changes, 0 - no redrawing
+    Scene(Device *device, VkExtent2D extent, uint32_t frameCount, float idleFps);
 
     ~Scene();
 
-    Buffer* getCameraBuffer() const;
+    DescriptorInfo getCameraBufferInfo() const;
 
     DescriptorInfo getLightingBufferInfo() const;
 
@@ -37,18 +42,38 @@ public:
 
     DescriptorInfo getModelTransformationBufferInfo(ModelId id);
 
+    // offset which must be applied to every dynamic uniform buffer of the scene in specified frame
+    uint32_t getUniformDynamicOffset(uint32_t frameIndex) const;
+
     void handleMotion(glm::vec2 delta);
 
     void handleZoom(float delta);
 
     void skipTime();
 
-    void update();
+    // marks scene as changed, so it will be redrawn in the next frame
+    void invalidate();
+
+    // scene is changed by user or animation since last update
+    bool isRedrawRequired() const;
+
+    // updates scene and writes its uniform data to the part of frame
+    void update(uint32_t frameIndex);
 
     void activateGallery();
 
     void resize(VkExtent2D newExtent);
 
+    // continues streaming of textures and tiles, returns true when streamed levels must be published
+    bool updateTextures();
+
+    // makes streamed levels visible, descriptors of earth and clouds must be updated after that,
+    // previous views are sampled by frames which are submitted until frameNumber (inclusive)
+    void publishTextures(uint64_t frameNumber);
+
+    // destroys previous views of published textures which aren't sampled by frames anymore
+    void releaseTextureViews(uint64_t completedFrameNumber);
+
     void drawSphere(VkCommandBuffer commandBuffer) const;
 
     void drawCube(VkCommandBuffer commandBuffer) const;
@@ -67,6 +92,11 @@ private:
         MESH_BUFFER_COUNT
     };
 
+    // size of uniform data of one frame (with alignment reserve)
+    const VkDeviceSize UNIFORM_FRAME_SIZE = 4096;
+
+    RingBuffer *uniformBuffer;
+
     Camera *camera;
 
     Controller *controller;
@@ -75,8 +105,14 @@ private:
 
     std::vector<Buffer*> meshBuffers;
 
+    TextureStreamer *textureStreamer;
+
     Timer timer;
 
+    float idleFrameInterval;
+
+    bool dirty = true;
+
     std::vector<Model*> models;
 
     Earth *earth;
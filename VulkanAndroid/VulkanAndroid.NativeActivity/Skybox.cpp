@@ -1,17 +1,44 @@
 #include "Skybox.h"
 #include "ActivityManager.h"
 
-Skybox::Skybox(Device *device, const std::string &texturePath) : Model(device)
+Skybox::Skybox(Device *device, TextureLoader *textureLoader, RingBuffer *uniformBuffer, const std::string &texturePath)
+    : Model(uniformBuffer)
 {
-    std::vector<std::vector<uint8_t>> buffers(CUBE_MAP_FILES.size());
-    for(uint32_t i = 0; i < buffers.size(); i++)
+    std::vector<std::string> paths;
+
+    // one KTX 2.0 cube map with pre-generated mip levels (compressed if supported) is preferred to separate faces
+    const std::string cubeMapPath = TextureImage::findAsset(device, texturePath + CUBE_MAP_KTX2_FILE);
+    if (ActivityManager::hasAsset(cubeMapPath))
+    {
+        paths.push_back(cubeMapPath);
+    }
+    else
+    {
+        for (const auto &file : CUBE_MAP_FILES)
+        {
+            paths.push_back(texturePath + file);
+        }
+    }
+
+    // faces are decoded in parallel
+    std::vector<TextureLoader::Reader> readers;
+    for (const auto &path : paths)
     {
-        buffers[i] = ActivityManager::readAsset(texturePath + CUBE_MAP_FILES[i]);
+        readers.push_back([path]() { return ActivityManager::openAsset(path); });
     }
 
-    cubeTexture = new TextureImage(device, buffers,  true, true);
-    cubeTexture->pushFullView(VK_IMAGE_ASPECT_COLOR_BIT);
-    cubeTexture->pushSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+    textureLoader->load(
+        texturePath,
+        readers,
+        STBI_rgb_alpha,
+        true,
+        true,
+        [this](TextureImage *texture)
+        {
+            texture->pushFullView(VK_IMAGE_ASPECT_COLOR_BIT);
+            texture->pushSampler(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+            cubeTexture = texture;
+        });
 }
 
 Skybox::~Skybox()
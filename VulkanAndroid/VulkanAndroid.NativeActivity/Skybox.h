@@ -1,11 +1,12 @@
 #pragma once
 #include "Model.h"
-#include "TextureImage.h"
+#include "TextureLoader.h"
 
 class Skybox : public Model
 {
 public:
-    Skybox(Device *device, const std::string &texturePath);
+    // textures are created by loader after decoding
+    Skybox(Device *device, TextureLoader *textureLoader, RingBuffer *uniformBuffer, const std::string &texturePath);
 
     virtual ~Skybox();
 
@@ -23,6 +24,9 @@ private:
         "Top.png"
     };
 
+    // faces are stored in the same order as CUBE_MAP_FILES
+    const std::string CUBE_MAP_KTX2_FILE = "Cube.ktx2";
+
     TextureImage *cubeTexture;
 };
 
@@ -1,20 +1,14 @@
 #include "StagingBuffer.h"
 
-StagingBuffer::StagingBuffer(Device *device, VkDeviceSize size) : device(device), size(size)
+StagingBuffer::StagingBuffer(Device *device, VkDeviceSize size)
+    : StagingBuffer(device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
 {
-	createBuffer(
-		device,
-		size,
-		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		&stagingBuffer,
-		&stagingMemory);
 }
 
 StagingBuffer::~StagingBuffer()
 {
-	vkFreeMemory(device->get(), stagingMemory, nullptr);
 	vkDestroyBuffer(device->get(), stagingBuffer, nullptr);
+	device->getMemoryAllocator()->free(stagingMemory);
 }
 
 VkBuffer StagingBuffer::get() const
@@ -36,16 +30,26 @@ void StagingBuffer::updateData(const void *data, VkDeviceSize offset, VkDeviceSi
 
 	LOGA(offset + dataSize <= size);
 
-	void *bufferData;
-	vkMapMemory(device->get(), stagingMemory, offset, dataSize, 0, &bufferData);
-	memcpy(bufferData, data, dataSize);
-	vkUnmapMemory(device->get(), stagingMemory);
+	memcpy(stagingMemory.mappedData + offset, data, dataSize);
 }
 
-void StagingBuffer::copyToImage(VkImage image, std::vector<VkBufferImageCopy> regions) const
+void StagingBuffer::updateLayers(const std::vector<const void*> &layers, VkDeviceSize layerSize)
 {
-    VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
+	const VkDeviceSize dataSize = layerSize * layers.size();
 
+	LOGA(dataSize <= size);
+
+	for (uint32_t i = 0; i < layers.size(); i++)
+	{
+		memcpy(stagingMemory.mappedData + i * layerSize, layers[i], layerSize);
+	}
+}
+
+void StagingBuffer::copyToImage(
+    VkCommandBuffer commandBuffer,
+    VkImage image,
+    const std::vector<VkBufferImageCopy> &regions) const
+{
 	vkCmdCopyBufferToImage(
         commandBuffer,
         stagingBuffer,
@@ -53,17 +57,47 @@ void StagingBuffer::copyToImage(VkImage image, std::vector<VkBufferImageCopy> re
         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 		uint32_t(regions.size()),
         regions.data());
+}
+
+void StagingBuffer::copyToImage(VkImage image, const std::vector<VkBufferImageCopy> &regions) const
+{
+    VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
+
+    copyToImage(commandBuffer, image, regions);
 
 	device->endOneTimeCommands(commandBuffer);
 }
 
+StagingBuffer::StagingBuffer(
+    Device *device,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkMemoryPropertyFlags preferredProperties,
+    MemoryAllocator::Category category)
+    : device(device), size(size)
+{
+	createBuffer(
+		device,
+		size,
+		usage,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		&stagingBuffer,
+		&stagingMemory,
+		preferredProperties,
+		MemoryAllocator::STRATEGY_FREE_LIST,
+		category);
+}
+
 void StagingBuffer::createBuffer(
     Device *device,
     VkDeviceSize size,
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags properties,
     VkBuffer *buffer,
-    VkDeviceMemory *memory)
+    MemoryAllocator::Allocation *memory,
+    VkMemoryPropertyFlags preferredProperties,
+    MemoryAllocator::Strategy strategy,
+    MemoryAllocator::Category category)
 {
 	VkBufferCreateInfo createInfo{
 		VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
@@ -78,30 +112,27 @@ void StagingBuffer::createBuffer(
 
     CALL_VK(vkCreateBuffer(device->get(), &createInfo, nullptr, buffer));
 
-	allocateMemory(device, *buffer, memory, properties);
+	allocateMemory(device, *buffer, memory, properties, preferredProperties, strategy, category);
 
-	vkBindBufferMemory(device->get(), *buffer, *memory, 0);
+	vkBindBufferMemory(device->get(), *buffer, memory->memory, memory->offset);
 }
 
 void StagingBuffer::allocateMemory(
     Device *device,
     VkBuffer buffer,
-    VkDeviceMemory *memory,
-    VkMemoryPropertyFlags properties)
+    MemoryAllocator::Allocation *memory,
+    VkMemoryPropertyFlags properties,
+    VkMemoryPropertyFlags preferredProperties,
+    MemoryAllocator::Strategy strategy,
+    MemoryAllocator::Category category)
 {
 	VkMemoryRequirements memRequirements;
 	vkGetBufferMemoryRequirements(device->get(), buffer, &memRequirements);
 
-    const uint32_t memoryTypeIndex = device->findMemoryTypeIndex(
-		memRequirements.memoryTypeBits,
-		properties);
-
-	VkMemoryAllocateInfo allocInfo{
-		VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-		nullptr,				
-		memRequirements.size,	
-		memoryTypeIndex,		
-	};
-
-    CALL_VK(vkAllocateMemory(device->get(), &allocInfo, nullptr, memory));
+	*memory = device->getMemoryAllocator()->allocate(
+		memRequirements,
+		properties,
+		preferredProperties,
+		strategy,
+		category);
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "Device.h"
+#include "MemoryAllocator.h"
 
 // buffer that can be mapped into host memory
 class StagingBuffer
@@ -15,29 +16,49 @@ public:
 
 	virtual void updateData(const void *data, VkDeviceSize offset = 0, VkDeviceSize dataSize = VkDeviceSize(-1));
 
-	void copyToImage(VkImage image, std::vector<VkBufferImageCopy> regions) const;
+	// writes layers of equal size one after another with single mapping
+	void updateLayers(const std::vector<const void*> &layers, VkDeviceSize layerSize);
 
-protected:
-	Device *device;
+	void copyToImage(VkCommandBuffer commandBuffer, VkImage image, const std::vector<VkBufferImageCopy> &regions) const;
 
-	VkBuffer stagingBuffer;
-
-	VkDeviceSize size;
-
-	VkDeviceMemory stagingMemory;
+	void copyToImage(VkImage image, const std::vector<VkBufferImageCopy> &regions) const;
 
+	// creates buffer with bound memory of such properties (used by all kinds of buffers)
 	static void createBuffer(
 		Device *device,
 		VkDeviceSize size,
 		VkBufferUsageFlags usage,
 		VkMemoryPropertyFlags properties,
 		VkBuffer *buffer,
-		VkDeviceMemory *memory);
+		MemoryAllocator::Allocation *memory,
+		VkMemoryPropertyFlags preferredProperties = 0,
+		MemoryAllocator::Strategy strategy = MemoryAllocator::STRATEGY_FREE_LIST,
+		MemoryAllocator::Category category = MemoryAllocator::CATEGORY_STAGING);
 
 	static void allocateMemory(
         Device *device,
         VkBuffer buffer,
-        VkDeviceMemory *memory,
-        VkMemoryPropertyFlags properties);
+        MemoryAllocator::Allocation *memory,
+        VkMemoryPropertyFlags properties,
+        VkMemoryPropertyFlags preferredProperties = 0,
+        MemoryAllocator::Strategy strategy = MemoryAllocator::STRATEGY_FREE_LIST,
+        MemoryAllocator::Category category = MemoryAllocator::CATEGORY_STAGING);
+
+protected:
+	Device *device;
+
+	VkBuffer stagingBuffer;
+
+	VkDeviceSize size;
+
+	// host visible memory is persistently mapped by allocator
+	MemoryAllocator::Allocation stagingMemory;
+
+	StagingBuffer(
+		Device *device,
+		VkDeviceSize size,
+		VkBufferUsageFlags usage,
+		VkMemoryPropertyFlags preferredProperties = 0,
+		MemoryAllocator::Category category = MemoryAllocator::CATEGORY_STAGING);
 };
 
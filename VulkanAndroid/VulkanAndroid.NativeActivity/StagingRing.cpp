@@ -0,0 +1,138 @@
+#include "StagingRing.h"
+#include "UploadContext.h"
+
+StagingRing::StagingRing(Device *device, VkDeviceSize size) : StagingBuffer(device, size)
+{
+}
+
+StagingRing::~StagingRing()
+{
+    while (!submissions.empty())
+    {
+        CALL_VK(vkWaitForFences(device->get(), 1, &submissions.front().fence, true, UINT64_MAX));
+        recycle();
+    }
+
+    for (auto fence : freeFences)
+    {
+        vkDestroyFence(device->get(), fence, nullptr);
+    }
+}
+
+VkDeviceSize StagingRing::getCapacity() const
+{
+    return size;
+}
+
+StagingRing::Region StagingRing::allocate(VkDeviceSize regionSize)
+{
+    LOGA(regionSize <= size);
+
+    VkDeviceSize begin;
+
+    while (true)
+    {
+        begin = (head + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT * REGION_ALIGNMENT;
+
+        // region doesn't wrap around, so the rest of buffer is skipped
+        if (begin % size + regionSize > size)
+        {
+            begin = (begin / size + 1) * size;
+        }
+
+        if (begin + regionSize - tail <= size)
+        {
+            break;
+        }
+
+        if (submissions.empty())
+        {
+            // regions are in use by recorded but not submitted commands
+            UploadContext *uploadContext = device->getUploadContext();
+            LOGA(uploadContext);
+
+            uploadContext->flush();
+
+            // flush could recycle its regions
+            continue;
+        }
+
+        CALL_VK(vkWaitForFences(device->get(), 1, &submissions.front().fence, true, UINT64_MAX));
+        recycle();
+    }
+
+    head = begin + regionSize;
+
+    const VkDeviceSize offset = begin % size;
+
+    return Region{ stagingBuffer, offset, stagingMemory.mappedData + offset };
+}
+
+void StagingRing::submit(VkQueue queue)
+{
+    if (submitted == head)
+    {
+        return;
+    }
+
+    VkFence fence;
+    if (freeFences.empty())
+    {
+        VkFenceCreateInfo fenceInfo{
+            VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+            nullptr,
+            0
+        };
+        CALL_VK(vkCreateFence(device->get(), &fenceInfo, nullptr, &fence));
+    }
+    else
+    {
+        fence = freeFences.back();
+        freeFences.pop_back();
+    }
+
+    // fence of empty batch is signaled when all previously submitted commands of queue are completed
+    CALL_VK(vkQueueSubmit(queue, 0, nullptr, fence));
+
+    submissions.push_back({ head, fence });
+    submitted = head;
+}
+
+void StagingRing::update()
+{
+    while (!submissions.empty())
+    {
+        const VkResult status = vkGetFenceStatus(device->get(), submissions.front().fence);
+        if (status == VK_NOT_READY)
+        {
+            return;
+        }
+        CALL_VK(status);
+
+        recycle();
+    }
+}
+
+VkDeviceSize StagingRing::getUsedSize() const
+{
+    return head - tail;
+}
+
+void StagingRing::recycle()
+{
+    const Submission &submission = submissions.front();
+
+    CALL_VK(vkResetFences(device->get(), 1, &submission.fence));
+    freeFences.push_back(submission.fence);
+
+    tail = submission.end;
+    submissions.pop_front();
+
+    // empty ring starts from the beginning of buffer
+    if (tail == head)
+    {
+        head = 0;
+        tail = 0;
+        submitted = 0;
+    }
+}
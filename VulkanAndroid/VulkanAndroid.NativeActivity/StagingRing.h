@@ -0,0 +1,67 @@
+#pragma once
+#include "StagingBuffer.h"
+#include <deque>
+
+// persistently mapped staging memory shared by all uploads of device:
+// regions are borrowed by uploads and recycled in allocation order when submissions which read them are completed,
+// completion of each submission is tracked by fence of empty batch submitted after it
+class StagingRing : public StagingBuffer
+{
+public:
+    struct Region
+    {
+        VkBuffer buffer;
+        VkDeviceSize offset;
+        void *data;
+    };
+
+    StagingRing(Device *device, VkDeviceSize size);
+
+    // waits for submissions which read regions
+    ~StagingRing();
+
+    // maximal size of one region, larger uploads must be split
+    VkDeviceSize getCapacity() const;
+
+    // when ring is full, the oldest submission is waited,
+    // regions which are recorded by active upload context are submitted by its flush
+    Region allocate(VkDeviceSize regionSize);
+
+    // regions allocated since previous call are read by commands which have been submitted to queue
+    void submit(VkQueue queue);
+
+    // recycles regions of completed submissions without waiting (called every frame)
+    void update();
+
+    // amount of staging memory in use
+    VkDeviceSize getUsedSize() const;
+
+private:
+    // regions read by commands submitted before fence
+    struct Submission
+    {
+        // end of the last region (position in allocated bytes)
+        VkDeviceSize end;
+
+        VkFence fence;
+    };
+
+    // offset alignment for vkCmdCopyBuffer and vkCmdCopyBufferToImage of any format
+    const VkDeviceSize REGION_ALIGNMENT = 16;
+
+    // positions grow monotonically, offset of position in buffer is position % size,
+    // regions between tail and head are in use
+    VkDeviceSize head = 0;
+
+    VkDeviceSize tail = 0;
+
+    // position of the first region which isn't submitted
+    VkDeviceSize submitted = 0;
+
+    std::deque<Submission> submissions;
+
+    // fences of completed submissions for reuse
+    std::vector<VkFence> freeFences;
+
+    void recycle();
+};
@@ -0,0 +1,276 @@
+#include "StreamingTexture.h"
+#include "StagingBuffer.h"
+#include <algorithm>
+
+StreamingTexture::StreamingTexture(
+    Device *device,
+    ThreadPool *threadPool,
+    const std::string &path,
+    AssetView file,
+    bool cubeMap)
+    : threadPool(threadPool), path(path), file(std::move(file))
+{
+    timer.getDeltaSec();
+
+    const Ktx2File header(this->file.getData(), this->file.getSize());
+
+    LOGA(device->getFormatProperties(header.getFormat()).optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+
+    const uint32_t levelCount = (std::max)(header.getMipLevelCount(), 1u);
+    cubeMap = cubeMap || header.getFaceCount() == 6;
+
+    createThisImage(
+        device,
+        0,
+        header.getFormat(),
+        header.getExtent(),
+        levelCount,
+        header.getLayerCount(),
+        VK_SAMPLE_COUNT_1_BIT,
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        cubeMap);
+
+    viewType = VK_IMAGE_VIEW_TYPE_2D;
+    if (cubeMap)
+    {
+        viewType = VK_IMAGE_VIEW_TYPE_CUBE;
+    }
+    else if (arrayLayers > 1)
+    {
+        viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    }
+
+    levels.resize(levelCount);
+    for (uint32_t i = 0; i < levelCount; i++)
+    {
+        levels[i] = header.getLevel(i);
+    }
+
+    // mip tail - the last level and all levels which aren't larger than TAIL_SIZE
+    residentLevel = levelCount - 1;
+    while (residentLevel > 0
+        && (std::max)(extent.width >> (residentLevel - 1), extent.height >> (residentLevel - 1)) <= TAIL_SIZE)
+    {
+        residentLevel--;
+    }
+    uploadedLevel = residentLevel;
+
+    // levels of tail are copied at once
+    VkDeviceSize dataBegin = levels[residentLevel].offset;
+    VkDeviceSize dataEnd = 0;
+    for (uint32_t i = residentLevel; i < levelCount; i++)
+    {
+        dataBegin = (std::min)(dataBegin, levels[i].offset);
+        dataEnd = (std::max)(dataEnd, levels[i].offset + levels[i].size);
+    }
+
+    VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
+    StagingBuffer *tailStagingBuffer = recordUpload(commandBuffer, residentLevel, levelCount - residentLevel, dataBegin, dataEnd);
+    transitLayout(
+        commandBuffer,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        {
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            residentLevel,
+            levelCount - residentLevel,
+            0,
+            arrayLayers
+        });
+    device->endOneTimeCommands(commandBuffer);
+
+    releaseStagingBuffer(tailStagingBuffer);
+
+    pushResidentView();
+
+    // copies of whole levels are allowed by any transfer granularity
+    upload = new AsyncUpload(device);
+
+    if (residentLevel > 0)
+    {
+        readLevel(residentLevel - 1);
+    }
+
+    LOGI("Texture streaming started: %s, %d of %d levels resident.",
+        path.c_str(),
+        levelCount - residentLevel,
+        levelCount);
+}
+
+StreamingTexture::~StreamingTexture()
+{
+    // worker reads pages of file
+    if (levelRead.valid())
+    {
+        levelRead.wait();
+    }
+
+    delete upload;
+}
+
+bool StreamingTexture::update()
+{
+    if (upload->isPending())
+    {
+        if (!upload->update())
+        {
+            return uploadedLevel < residentLevel;
+        }
+
+        uploadedLevel--;
+        if (uploadedLevel > 0)
+        {
+            readLevel(uploadedLevel - 1);
+        }
+    }
+    else if (levelRead.valid() && levelRead.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        const uint32_t level = uploadedLevel - 1;
+        levelRead.get();
+
+        const VkCommandBuffer commandBuffer = upload->begin();
+
+        StagingBuffer *stagingBuffer = recordUpload(
+            commandBuffer,
+            level,
+            1,
+            levels[level].offset,
+            levels[level].offset + levels[level].size);
+
+        // level isn't sampled until it's published, so it's released to graphics queue family
+        upload->finishImage(
+            this,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            {
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                level,
+                1,
+                0,
+                arrayLayers
+            });
+
+        // only this level is written, so frames which sample published levels aren't waited
+        upload->submit(stagingBuffer);
+    }
+
+    return uploadedLevel < residentLevel;
+}
+
+VkImageView StreamingTexture::publish()
+{
+    if (uploadedLevel == residentLevel)
+    {
+        return VK_NULL_HANDLE;
+    }
+
+    residentLevel = uploadedLevel;
+
+    // texture has only one view - view of resident levels
+    const VkImageView previousView = views[0];
+    views.clear();
+    pushResidentView();
+
+    if (residentLevel == 0)
+    {
+        LOGI("Texture streamed: %s, %d levels in %.1f ms.", path.c_str(), mipLevels, timer.getElapsedSec() * 1000.0f);
+    }
+
+    return previousView;
+}
+
+bool StreamingTexture::isUploaded() const
+{
+    return uploadedLevel == 0;
+}
+
+bool StreamingTexture::isResident() const
+{
+    return residentLevel == 0;
+}
+
+uint32_t StreamingTexture::getResidentLevel() const
+{
+    return residentLevel;
+}
+
+void StreamingTexture::readLevel(uint32_t level)
+{
+    const Ktx2File::Level location = levels[level];
+
+    // level is copied from file to staging buffer without waiting for storage
+    levelRead = threadPool->submit([this, location]()
+    {
+        file.prefetch(size_t(location.offset), size_t(location.size));
+    });
+}
+
+StagingBuffer* StreamingTexture::recordUpload(
+    VkCommandBuffer commandBuffer,
+    uint32_t baseLevel,
+    uint32_t levelCount,
+    VkDeviceSize dataBegin,
+    VkDeviceSize dataEnd)
+{
+    auto uploadStagingBuffer = new StagingBuffer(device, dataEnd - dataBegin);
+    uploadStagingBuffer->updateData(file.getData() + dataBegin, 0, dataEnd - dataBegin);
+
+    // one region per level contains all layers
+    std::vector<VkBufferImageCopy> regions(levelCount);
+    for (uint32_t i = 0; i < levelCount; i++)
+    {
+        const uint32_t level = baseLevel + i;
+        regions[i] = VkBufferImageCopy{
+            levels[level].offset - dataBegin,
+            0,
+            0,
+            {
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                level,
+                0,
+                arrayLayers
+            },
+            { 0, 0, 0 },
+            {
+                (std::max)(extent.width >> level, 1u),
+                (std::max)(extent.height >> level, 1u),
+                (std::max)(extent.depth >> level, 1u)
+            }
+        };
+    }
+
+    const VkImageSubresourceRange subresourceRange{
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        baseLevel,
+        levelCount,
+        0,
+        arrayLayers
+    };
+
+    transitLayout(
+        commandBuffer,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        subresourceRange);
+
+    uploadStagingBuffer->copyToImage(commandBuffer, image, regions);
+
+    return uploadStagingBuffer;
+}
+
+void StreamingTexture::pushResidentView()
+{
+    const VkImageSubresourceRange subresourceRange{
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        residentLevel,
+        mipLevels - residentLevel,
+        0,
+        arrayLayers
+    };
+
+    pushView(viewType, subresourceRange);
+}
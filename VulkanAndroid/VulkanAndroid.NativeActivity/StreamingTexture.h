@@ -0,0 +1,81 @@
+#pragma once
+#include "TextureImage.h"
+#include "AsyncUpload.h"
+#include "ThreadPool.h"
+#include "Timer.h"
+
+// texture of KTX 2.0 asset with pre-generated mip levels which is resident before its data:
+// small levels (mip tail) are uploaded at creation, pages of larger levels are read by worker thread
+// and levels are uploaded by transfer queue without waiting one after another; view is limited to published levels,
+// so memory of all levels is allocated at once, but only published levels are sampled
+class StreamingTexture : public TextureImage
+{
+public:
+    // levels which aren't larger than TAIL_SIZE are resident after creation,
+    // file - view of KTX 2.0 asset (see Ktx2File) which is kept until texture is destroyed
+    StreamingTexture(
+        Device *device,
+        ThreadPool *threadPool,
+        const std::string &path,
+        AssetView file,
+        bool cubeMap);
+
+    ~StreamingTexture();
+
+    // continues streaming (must be called regularly by thread which owns device queues),
+    // returns true when uploaded levels are waiting for publish
+    bool update();
+
+    // recreates view with uploaded levels, returns previous view (VK_NULL_HANDLE if nothing is published)
+    // which is owned by caller and must be destroyed when commands which sample it are completed
+    VkImageView publish();
+
+    // all levels are uploaded
+    bool isUploaded() const;
+
+    // all levels are published
+    bool isResident() const;
+
+    // the largest sampled level
+    uint32_t getResidentLevel() const;
+
+private:
+    static const uint32_t TAIL_SIZE = 64;
+
+    ThreadPool *threadPool;
+
+    std::string path;
+
+    AssetView file;
+
+    VkImageViewType viewType;
+
+    std::vector<Ktx2File::Level> levels;
+
+    // view starts from this level
+    uint32_t residentLevel;
+
+    // levels from this one are uploaded and can be published
+    uint32_t uploadedLevel;
+
+    // reading of pages of level which is previous to uploaded one
+    std::future<void> levelRead;
+
+    // level which is uploaded by transfer queue
+    AsyncUpload *upload;
+
+    Timer timer;
+
+    void readLevel(uint32_t level);
+
+    // records transition of levels to TRANSFER_DST and their copying (range of file from dataBegin to dataEnd),
+    // returned staging buffer must live until commands are completed
+    StagingBuffer* recordUpload(
+        VkCommandBuffer commandBuffer,
+        uint32_t baseLevel,
+        uint32_t levelCount,
+        VkDeviceSize dataBegin,
+        VkDeviceSize dataEnd);
+
+    void pushResidentView();
+};
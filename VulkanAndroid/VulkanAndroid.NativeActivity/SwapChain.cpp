@@ -2,7 +2,8 @@
 #include "SurfaceSupportDetails.h"
 #include <algorithm>
 
-SwapChain::SwapChain(Device *device, VkSurfaceKHR surface, VkExtent2D surfaceExtent) : device(device), surface(surface)
+SwapChain::SwapChain(Device *device, VkSurfaceKHR surface, VkExtent2D surfaceExtent, Policy policy)
+    : device(device), policy(policy), surface(surface)
 {
 	create(surfaceExtent);
 
@@ -39,6 +40,16 @@ VkFormat SwapChain::getImageFormat() const
     return imageFormat;
 }
 
+VkPresentModeKHR SwapChain::getPresentMode() const
+{
+    return presentMode;
+}
+
+SwapChain::Policy SwapChain::getPolicy() const
+{
+    return policy;
+}
+
 void SwapChain::recreate(VkExtent2D newExtent)
 {
 	cleanup();
@@ -60,7 +71,7 @@ void SwapChain::create(VkExtent2D surfaceExtent)
     // get necessary swapchain properties
 	const auto details = device->getSurfaceSupportDetails();
     const auto surfaceFormat = chooseSurfaceFormat(details.getFormats());
-    const auto presentMode = choosePresentMode(details.getPresentModes());
+    presentMode = choosePresentMode(details.getPresentModes());
 	const auto surfaceCapabilities = details.getCapabilities();
     const auto imageFeatures = device->getFormatProperties(surfaceFormat.format).optimalTilingFeatures;
 
@@ -74,7 +85,7 @@ void SwapChain::create(VkExtent2D surfaceExtent)
 		nullptr,
 		0,
 		surface,
-        surfaceCapabilities.minImageCount,
+        chooseImageCount(surfaceCapabilities),
 		surfaceFormat.format,
 		surfaceFormat.colorSpace,
 		extent,
@@ -90,13 +101,16 @@ void SwapChain::create(VkExtent2D surfaceExtent)
 	    nullptr
 	};
 
-	// concurrent sharing mode only when using different queue families
+	// concurrent sharing mode only when using different queue families:
+	// images are written by computing, then by gallery rendering and presented
     const QueueFamilyIndices queueFamilyIndices = device->getQueueFamilyIndices();
-	std::vector<uint32_t> indices{
+	const std::set<uint32_t> uniqueIndices{
+		queueFamilyIndices.getGraphics(),
 		queueFamilyIndices.getCompute(),
 		queueFamilyIndices.getPresentation()
 	};
-	if (indices[0] != indices[1])
+	const std::vector<uint32_t> indices(uniqueIndices.begin(), uniqueIndices.end());
+	if (indices.size() > 1)
 	{
 		createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
 		createInfo.queueFamilyIndexCount = uint32_t(indices.size());
@@ -109,7 +123,8 @@ void SwapChain::create(VkExtent2D surfaceExtent)
     LOGD("SwapChain extent: %d x %d.", extent.width, extent.height);
     LOGD("SwapChain format: %d.", surfaceFormat.format);
     LOGD("SwapChain color space: %d.", surfaceFormat.colorSpace);
-    LOGD("SwapChain present mode: %d.", presentMode);
+    LOGI("SwapChain policy: %s.", policy == POLICY_LOW_LATENCY ? "low latency" : "high throughput");
+    LOGI("SwapChain present mode: %d.", presentMode);
 }
 
 VkSurfaceFormatKHR SwapChain::chooseSurfaceFormat(std::vector<VkSurfaceFormatKHR> availableFormats) const
@@ -136,18 +151,39 @@ VkSurfaceFormatKHR SwapChain::chooseSurfaceFormat(std::vector<VkSurfaceFormatKHR
 
 VkPresentModeKHR SwapChain::choosePresentMode(std::vector<VkPresentModeKHR> availablePresentModes) const
 {
-	for (const auto &availablePresentMode : availablePresentModes)
+	if (policy == POLICY_LOW_LATENCY)
 	{
-		if (availablePresentMode == PREFERRED_PRESENT_MODE)
+		for (const auto &preferredPresentMode : LOW_LATENCY_PRESENT_MODES)
 		{
-			return availablePresentMode;
+			if (std::find(availablePresentModes.begin(), availablePresentModes.end(), preferredPresentMode) != availablePresentModes.end())
+			{
+				return preferredPresentMode;
+			}
 		}
 	}
 
-	// simplest mode
+	// simplest mode, always available
 	return VK_PRESENT_MODE_FIFO_KHR;
 }
 
+uint32_t SwapChain::chooseImageCount(VkSurfaceCapabilitiesKHR capabilities) const
+{
+	uint32_t imageCount = capabilities.minImageCount;
+
+	if (policy == POLICY_HIGH_THROUGHPUT)
+	{
+		imageCount += HIGH_THROUGHPUT_EXTRA_IMAGE_COUNT;
+	}
+
+	// zero means that there is no limit
+	if (capabilities.maxImageCount > 0)
+	{
+		imageCount = (std::min)(imageCount, capabilities.maxImageCount);
+	}
+
+	return imageCount;
+}
+
 VkExtent2D SwapChain::chooseExtent(VkSurfaceCapabilitiesKHR capabilities, VkExtent2D actualExtent)
 {
 	// can choose any extent
@@ -205,7 +241,7 @@ void SwapChain::saveImages()
             subresourceRange);
     }
 
-    LOGD("SwapChain image count: %d.", uint32_t(images.size()));
+    LOGI("SwapChain image count: %d.", uint32_t(images.size()));
 }
 
 void SwapChain::cleanup()
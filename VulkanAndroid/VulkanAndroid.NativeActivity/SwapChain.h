@@ -5,7 +5,15 @@
 class SwapChain
 {
 public:
-	SwapChain(Device *device, VkSurfaceKHR surface, VkExtent2D surfaceExtent);
+	// latency - mailbox or immediate present mode and minimal image count,
+	// throughput - fifo present mode and additional images for smooth frame rate
+	enum Policy
+	{
+		POLICY_LOW_LATENCY,
+		POLICY_HIGH_THROUGHPUT
+	};
+
+	SwapChain(Device *device, VkSurfaceKHR surface, VkExtent2D surfaceExtent, Policy policy);
 
 	~SwapChain();
 
@@ -19,6 +27,10 @@ public:
 
 	VkFormat getImageFormat() const;
 
+	VkPresentModeKHR getPresentMode() const;
+
+	Policy getPolicy() const;
+
 	void recreate(VkExtent2D newExtent);
 
     void recreate(VkSurfaceKHR surface, VkExtent2D newExtent);
@@ -26,10 +38,16 @@ public:
 private:
 	const VkSurfaceFormatKHR PREFERRED_PRESENT_FORMAT = { VK_FORMAT_R8G8B8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
 
-	const VkPresentModeKHR PREFERRED_PRESENT_MODE = VK_PRESENT_MODE_MAILBOX_KHR;
+	// present modes in order of preference, fifo is always available
+	const std::vector<VkPresentModeKHR> LOW_LATENCY_PRESENT_MODES{ VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR };
+
+	// images above minimal count in high throughput policy
+	const uint32_t HIGH_THROUGHPUT_EXTRA_IMAGE_COUNT = 1;
 
 	Device *device;
 
+	Policy policy;
+
 	VkSurfaceKHR surface;
 
 	VkSwapchainKHR swapChain;
@@ -38,6 +56,8 @@ private:
 
 	VkFormat imageFormat;
 
+	VkPresentModeKHR presentMode;
+
     std::vector<Image*> images;
 
 	void create(VkExtent2D surfaceExtent);
@@ -46,6 +66,8 @@ private:
 
 	VkPresentModeKHR choosePresentMode(std::vector<VkPresentModeKHR> availablePresentModes) const;
 
+	uint32_t chooseImageCount(VkSurfaceCapabilitiesKHR capabilities) const;
+
 	static VkExtent2D chooseExtent(VkSurfaceCapabilitiesKHR capabilities, VkExtent2D actualExtent);
 
 	void saveImages();
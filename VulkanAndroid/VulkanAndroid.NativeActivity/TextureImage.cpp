@@ -1,51 +1,114 @@
 #include "TextureImage.h"
+#include "StagingBuffer.h"
+#include "ActivityManager.h"
+#include "utils.h"
+#include <algorithm>
 
-TextureImage::TextureImage(
-    Device *device,
-    const std::vector<std::vector<uint8_t>> &buffers,
-    bool mipLevels,
-    bool cubeMap)
+TextureImage::Decoded TextureImage::decode(std::vector<AssetView> files, uint32_t channelCount)
 {
-    extent = VkExtent3D{ 0, 0, 1 };
+    std::vector<Decoded> decodedFiles;
+    for (auto &file : files)
+    {
+        decodedFiles.push_back(decodeFile(std::move(file), channelCount));
+    }
+
+    return join(std::move(decodedFiles));
+}
+
+TextureImage::Decoded TextureImage::decodeFile(AssetView file, uint32_t channelCount)
+{
+    // 24-bit formats are rarely supported for sampling, so RGB is expanded to RGBA
+    if (channelCount != STBI_grey && channelCount != STBI_grey_alpha)
+    {
+        channelCount = STBI_rgb_alpha;
+    }
+
+    Decoded decoded{ {}, { 0, 0, 1 }, channelCount, {}, {} };
+
+    if (Ktx2File::isKtx2(file.getData(), file.getSize()))
+    {
+        // pages are read on this thread, so upload only copies them
+        decoded.ktx2 = std::move(file);
+        decoded.ktx2.prefetch(0, decoded.ktx2.getSize());
+        return decoded;
+    }
 
-    std::vector<const void*> pixels;
-    for (uint32_t i = 0; i < buffers.size(); i++)
+    // encoded image is decoded directly from view, view is closed after decoding
+    stbi_uc *loadedPixels = loadPixels(file, channelCount, &decoded.extent);
+    if (loadedPixels)
     {
-        stbi_uc *loadedPixels = loadPixels(buffers[i]);
-        if (loadedPixels)
+        decoded.layers.push_back(loadedPixels);
+    }
+    else
+    {
+        decoded.failedImages.insert(0);
+    }
+
+    return decoded;
+}
+
+TextureImage::Decoded TextureImage::join(std::vector<Decoded> files)
+{
+    if (files.size() == 1 && !files[0].ktx2.isEmpty())
+    {
+        return std::move(files[0]);
+    }
+
+    Decoded joined{ {}, { 0, 0, 1 }, files.empty() ? STBI_rgb_alpha : files[0].channelCount, {}, {} };
+
+    for (uint32_t i = 0; i < files.size(); i++)
+    {
+        if (files[i].layers.empty())
         {
-            pixels.push_back(loadedPixels);
+            joined.failedImages.insert(i);
+            continue;
+        }
+
+        if (joined.layers.empty())
+        {
+            joined.extent = files[i].extent;
+        }
+
+        const bool sameExtent = joined.extent.width == files[i].extent.width
+            && joined.extent.height == files[i].extent.height;
+        if (sameExtent)
+        {
+            joined.layers.push_back(files[i].layers[0]);
         }
         else
         {
-            failedImages.insert(i);
+            stbi_image_free(files[i].layers[0]);
+            joined.failedImages.insert(i);
         }
     }
 
-    createThisImage(
-        device,
-        0,
-        VK_FORMAT_R8G8B8A8_UNORM,
-        extent,
-        mipLevels ? calculateMipLevelCount(extent) : 1,
-        pixels.size(),
-        VK_SAMPLE_COUNT_1_BIT,
-        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-        cubeMap);
-
-    updateData(pixels, 0, STBI_rgb_alpha);
+    return joined;
+}
 
-    for (auto arrayLayerPixels : pixels)
+TextureImage::TextureImage(
+    Device *device,
+    Decoded decoded,
+    bool mipLevels,
+    bool cubeMap)
+    : failedImages(decoded.failedImages)
+{
+    if (!decoded.ktx2.isEmpty())
     {
-        stbi_image_free(const_cast<void*>(arrayLayerPixels));
+        loadKtx2(device, Ktx2File(decoded.ktx2.getData(), decoded.ktx2.getSize()), mipLevels, cubeMap);
+    }
+    else
+    {
+        loadImages(device, decoded, mipLevels, cubeMap);
     }
+}
 
-    generateMipmaps(
-        VK_IMAGE_ASPECT_COLOR_BIT,
-        VK_FILTER_LINEAR,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-        VK_ACCESS_SHADER_READ_BIT,
-        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+TextureImage::TextureImage(
+    Device *device,
+    std::vector<AssetView> files,
+    bool mipLevels,
+    bool cubeMap)
+    : TextureImage(device, decode(std::move(files)), mipLevels, cubeMap)
+{
 }
 
 TextureImage::TextureImage(
@@ -91,7 +154,7 @@ DescriptorInfo TextureImage::getCombineSamplerInfo(uint32_t samplerIndex, uint32
     info.image = VkDescriptorImageInfo{
         samplers[samplerIndex],
         views[viewIndex],
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        sampledLayout
     };
 
     return info;
@@ -137,33 +200,272 @@ void TextureImage::pushSampler(VkFilter filter, VkSamplerAddressMode addressMode
     samplers.push_back(sampler);
 }
 
-stbi_uc* TextureImage::loadPixels(const std::vector<uint8_t> &buffer)
+std::string TextureImage::findAsset(Device *device, const std::string &path)
+{
+    // compressed textures are sampled with linear filter
+    const VkFormatFeatureFlags requiredFeatures = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT
+        | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+    for (const auto &extension : COMPRESSED_EXTENSIONS)
+    {
+        const std::string variantPath = file::replaceExtension(path, extension);
+        if (!ActivityManager::hasAsset(variantPath))
+        {
+            continue;
+        }
+
+        // format is read from header, so only its page is read from storage
+        const AssetView file = ActivityManager::openAsset(variantPath);
+        const VkFormat format = Ktx2File(file.getData(), file.getSize()).getFormat();
+
+        const VkFormatFeatureFlags features = device->getFormatProperties(format).optimalTilingFeatures;
+        if ((features & requiredFeatures) == requiredFeatures)
+        {
+            return variantPath;
+        }
+    }
+
+    const std::string ktx2Path = file::replaceExtension(path, ".ktx2");
+    if (ActivityManager::hasAsset(ktx2Path))
+    {
+        return ktx2Path;
+    }
+
+    return path;
+}
+
+VkFormat TextureImage::getDecodedFormat(uint32_t channelCount)
+{
+    switch (channelCount)
+    {
+    case STBI_grey:
+        return VK_FORMAT_R8_UNORM;
+    case STBI_grey_alpha:
+        return VK_FORMAT_R8G8_UNORM;
+    default:
+        return VK_FORMAT_R8G8B8A8_UNORM;
+    }
+}
+
+stbi_uc* TextureImage::loadPixels(const AssetView &file, uint32_t channelCount, VkExtent3D *extent)
 {
     int width, height;
 
+    // stb_image converts color to luminance (and alpha) for less channels,
+    // so all channels are loaded and the first ones are kept (the same way as by asset cooker)
+    const uint32_t loadedChannelCount = STBI_rgb_alpha;
+
     stbi_uc *pixels = stbi_load_from_memory(
-        buffer.data(),
-        buffer.size(),
+        file.getData(),
+        int(file.getSize()),
         &width,
         &height,
         nullptr,
-        STBI_rgb_alpha);
+        int(loadedChannelCount));
 
     LOGA(pixels);
 
-    if (extent.width && extent.height)
+    if (channelCount < loadedChannelCount)
     {
-        const bool sameExtent = extent.width == uint32_t(width) && extent.height == uint32_t(height);
+        const size_t pixelCount = size_t(width) * size_t(height);
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            for (uint32_t j = 0; j < channelCount; j++)
+            {
+                pixels[i * channelCount + j] = pixels[i * loadedChannelCount + j];
+            }
+        }
+    }
+
+    if (extent->width && extent->height)
+    {
+        const bool sameExtent = extent->width == uint32_t(width) && extent->height == uint32_t(height);
         if (!sameExtent)
         {
+            stbi_image_free(pixels);
             return nullptr;
         }
     }
     else
     {
-        extent.width = uint32_t(width);
-        extent.height = uint32_t(height);
+        extent->width = uint32_t(width);
+        extent->height = uint32_t(height);
     }
 
     return pixels;
 }
+
+void TextureImage::loadImages(
+    Device *device,
+    const Decoded &decoded,
+    bool mipLevels,
+    bool cubeMap)
+{
+    extent = decoded.extent;
+
+    const std::vector<const void*> pixels(decoded.layers.begin(), decoded.layers.end());
+
+    // formats of all channel counts support blitting, so mip levels are generated the same way
+    createThisImage(
+        device,
+        0,
+        getDecodedFormat(decoded.channelCount),
+        extent,
+        mipLevels ? calculateMipLevelCount(extent) : 1,
+        pixels.size(),
+        VK_SAMPLE_COUNT_1_BIT,
+        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        cubeMap);
+
+    // transition, copying of all layers and mipmap generation in one submission
+    VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
+
+    StagingBuffer *stagingBuffer = updateData(commandBuffer, pixels, 0, decoded.channelCount);
+
+    for (auto arrayLayerPixels : pixels)
+    {
+        stbi_image_free(const_cast<void*>(arrayLayerPixels));
+    }
+
+    generateMipmaps(
+        commandBuffer,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        VK_FILTER_LINEAR,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+    device->endOneTimeCommands(commandBuffer);
+
+    releaseStagingBuffer(stagingBuffer);
+}
+
+void TextureImage::loadKtx2(Device *device, const Ktx2File &file, bool mipLevels, bool cubeMap)
+{
+    extent = file.getExtent();
+
+    LOGA(device->getFormatProperties(file.getFormat()).optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+
+    // levels are generated by blitting only if file doesn't contain them,
+    // compressed formats can't be blitted, so their levels must be pre-generated
+    const uint32_t storedLevelCount = (std::max)(file.getMipLevelCount(), 1u);
+    const bool generateLevels = mipLevels && storedLevelCount == 1 && !file.isBlockCompressed();
+    if (mipLevels && storedLevelCount == 1 && file.isBlockCompressed())
+    {
+        LOGE("Compressed KTX2 texture has no mip levels, levels can't be generated.");
+    }
+    const uint32_t copiedLevelCount = mipLevels ? storedLevelCount : 1;
+
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    if (generateLevels)
+    {
+        usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
+
+    createThisImage(
+        device,
+        0,
+        file.getFormat(),
+        extent,
+        generateLevels ? calculateMipLevelCount(extent) : copiedLevelCount,
+        file.getLayerCount(),
+        VK_SAMPLE_COUNT_1_BIT,
+        usage,
+        cubeMap || file.getFaceCount() == 6);
+
+    // levels are stored together, so all of them are written to staging buffer at once
+    VkDeviceSize dataBegin = file.getLevel(0).offset;
+    VkDeviceSize dataEnd = 0;
+    for (uint32_t i = 0; i < copiedLevelCount; i++)
+    {
+        const Ktx2File::Level level = file.getLevel(i);
+        dataBegin = (std::min)(dataBegin, level.offset);
+        dataEnd = (std::max)(dataEnd, level.offset + level.size);
+    }
+
+    auto stagingBuffer = new StagingBuffer(device, dataEnd - dataBegin);
+    stagingBuffer->updateData(file.getData() + dataBegin, 0, dataEnd - dataBegin);
+
+    // one region per level contains all layers
+    std::vector<VkBufferImageCopy> regions(copiedLevelCount);
+    for (uint32_t i = 0; i < copiedLevelCount; i++)
+    {
+        regions[i] = VkBufferImageCopy{
+            file.getLevel(i).offset - dataBegin,
+            0,
+            0,
+            {
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                i,
+                0,
+                arrayLayers
+            },
+            { 0, 0, 0 },
+            { 
+                (std::max)(extent.width >> i, 1u), 
+                (std::max)(extent.height >> i, 1u), 
+                (std::max)(extent.depth >> i, 1u) 
+            }
+        };
+    }
+
+    const VkImageSubresourceRange subresourceRange{
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        0,
+        this->mipLevels,
+        0,
+        arrayLayers
+    };
+
+    VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
+
+    transitLayout(
+        commandBuffer,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        subresourceRange);
+
+    stagingBuffer->copyToImage(commandBuffer, image, regions);
+
+    if (generateLevels)
+    {
+        generateMipmaps(
+            commandBuffer,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_FILTER_LINEAR,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_ACCESS_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    }
+    else
+    {
+        transitLayout(
+            commandBuffer,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            subresourceRange);
+    }
+
+    device->endOneTimeCommands(commandBuffer);
+
+    releaseStagingBuffer(stagingBuffer);
+
+    LOGD("KTX2 texture: %d x %d, format %d%s, %d layers, %d mip levels (%s).",
+        extent.width,
+        extent.height,
+        format,
+        file.isBlockCompressed() ? " (compressed)" : "",
+        arrayLayers,
+        this->mipLevels,
+        generateLevels ? "generated" : "pre-generated");
+}
+
+const std::array<std::string, 3> TextureImage::COMPRESSED_EXTENSIONS{
+    ".astc.ktx2",
+    ".etc2.ktx2",
+    ".bc7.ktx2"
+};
@@ -1,14 +1,56 @@
 #pragma once
 #include "Image.h"
+#include "Ktx2File.h"
+#include "AssetView.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 class TextureImage : public Image
 {
 public:
+    // layers of texture ready for upload, decoding doesn't use device, so it can be done on any thread
+    struct Decoded
+    {
+        // KTX 2.0 file is uploaded without decoding (directly from view)
+        AssetView ktx2;
+
+        VkExtent3D extent;
+
+        // 8-bit channels per pixel (1, 2 or 4)
+        uint32_t channelCount;
+
+        // pixels of layers (freed by texture)
+        std::vector<stbi_uc*> layers;
+
+        // indices of images which can't be decoded or have other extent
+        std::set<uint32_t> failedImages;
+    };
+
+    // files - encoded images (jpg, png) of layers or one KTX 2.0 file with all layers,
+    // channelCount - the first channels of images used by shaders (STBI_grey - R8, STBI_grey_alpha - RG8, others - RGBA8),
+    // format of KTX 2.0 file is defined by file
+    static Decoded decode(std::vector<AssetView> files, uint32_t channelCount = STBI_rgb_alpha);
+
+    // decodes one of files (see decode), so layers of texture can be decoded on different threads
+    static Decoded decodeFile(AssetView file, uint32_t channelCount = STBI_rgb_alpha);
+
+    // joins decoded files into one texture in the same order,
+    // images with other extent than the first decoded one are freed
+    static Decoded join(std::vector<Decoded> files);
+
+    // format of decoded images with channelCount channels
+    static VkFormat getDecodedFormat(uint32_t channelCount);
+
+    // pre-generated mip levels of KTX 2.0 file are used instead of runtime generation
+    TextureImage(
+        Device *device,
+        Decoded decoded,
+        bool mipLevels,
+        bool cubeMap);
+
     TextureImage(
         Device *device,
-        const std::vector<std::vector<uint8_t>> &buffers,
+        std::vector<AssetView> files,
         bool mipLevels,
         bool cubeMap);
 
@@ -33,11 +75,31 @@ public:
 
     void pushSampler(VkFilter filter, VkSamplerAddressMode addressMode);
 
+    // returns path of the best supported version of texture in assets:
+    // compressed KTX 2.0 (name.astc.ktx2, name.etc2.ktx2, name.bc7.ktx2) of format supported by device,
+    // uncompressed name.ktx2 or path itself
+    static std::string findAsset(Device *device, const std::string &path);
+
 protected:
+    // image is created by derived class
+    TextureImage() = default;
+
+    // extensions of compressed KTX 2.0 files in order of preference (quality per bit),
+    // one extension can contain several formats (e.g. EAC instead of ETC2 for textures with less channels)
+    static const std::array<std::string, 3> COMPRESSED_EXTENSIONS;
+
 	std::vector<VkSampler> samplers;
 
     std::set<uint32_t> failedImages;
 
-	stbi_uc* loadPixels(const std::vector<uint8_t> &buffer);
+    // layout of image in descriptors
+    VkImageLayout sampledLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	// extent of the first image is saved, images with other extent aren't loaded
+	static stbi_uc* loadPixels(const AssetView &file, uint32_t channelCount, VkExtent3D *extent);
+
+	void loadImages(Device *device, const Decoded &decoded, bool mipLevels, bool cubeMap);
+
+	void loadKtx2(Device *device, const Ktx2File &file, bool mipLevels, bool cubeMap);
 };
 
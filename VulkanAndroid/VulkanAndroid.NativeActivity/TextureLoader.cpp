@@ -0,0 +1,77 @@
+#include "TextureLoader.h"
+
+TextureLoader::TextureLoader(Device *device) : device(device)
+{
+    // calling thread is busy by uploads only after decoding, so all cores are used for decoding
+    threadPool = new ThreadPool();
+
+    timer.getDeltaSec();
+}
+
+TextureLoader::~TextureLoader()
+{
+    LOGA(requests.empty());
+
+    delete threadPool;
+}
+
+void TextureLoader::load(
+    const std::string &name,
+    std::vector<Reader> readers,
+    uint32_t channelCount,
+    bool mipLevels,
+    bool cubeMap,
+    Callback onLoaded)
+{
+    std::vector<std::future<Decoded>> decodedLayers;
+    for (const auto &read : readers)
+    {
+        decodedLayers.push_back(threadPool->submit([read, channelCount]()
+        {
+            Timer decodeTimer;
+            decodeTimer.getDeltaSec();
+
+            TextureImage::Decoded file = TextureImage::decodeFile(read(), channelCount);
+
+            return Decoded{ std::move(file), decodeTimer.getDeltaSec() };
+        }));
+    }
+
+    requests.push_back(Request{ name, mipLevels, cubeMap, onLoaded, std::move(decodedLayers) });
+}
+
+void TextureLoader::finish()
+{
+    float decodeTime = 0.0f;
+    float uploadTime = 0.0f;
+
+    for (auto &request : requests)
+    {
+        std::vector<TextureImage::Decoded> files;
+        for (uint32_t i = 0; i < request.decodedLayers.size(); i++)
+        {
+            Decoded decoded = request.decodedLayers[i].get();
+            decodeTime += decoded.time;
+            files.push_back(std::move(decoded.file));
+
+            LOGI("Texture decoded: %s, layer %d, %.1f ms.", request.name.c_str(), i, decoded.time * 1000.0f);
+        }
+
+        Timer uploadTimer;
+        uploadTimer.getDeltaSec();
+
+        TextureImage::Decoded texture = TextureImage::join(std::move(files));
+        request.onLoaded(new TextureImage(device, std::move(texture), request.mipLevels, request.cubeMap));
+
+        uploadTime += uploadTimer.getDeltaSec();
+    }
+
+    LOGI("Textures loaded: %d in %.1f ms on %d threads (decoding %.1f ms, uploading %.1f ms).",
+        uint32_t(requests.size()),
+        timer.getDeltaSec() * 1000.0f,
+        threadPool->getThreadCount(),
+        decodeTime * 1000.0f,
+        uploadTime * 1000.0f);
+
+    requests.clear();
+}
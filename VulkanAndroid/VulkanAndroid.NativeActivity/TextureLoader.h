@@ -0,0 +1,63 @@
+#pragma once
+#include "TextureImage.h"
+#include "ThreadPool.h"
+#include "Timer.h"
+
+// reads and decodes textures on thread pool while models of scene are created,
+// textures are created and uploaded on calling thread (owner of device queues) by finish
+class TextureLoader
+{
+public:
+    // returns view of one encoded layer of texture or KTX 2.0 file with all layers (called on worker thread)
+    using Reader = std::function<AssetView()>;
+
+    // receives created texture (called on calling thread by finish)
+    using Callback = std::function<void(TextureImage*)>;
+
+    TextureLoader(Device *device);
+
+    ~TextureLoader();
+
+    // starts reading and decoding of texture, name is used in log,
+    // each layer is read and decoded by its own task, so layers of one texture are decoded in parallel,
+    // channelCount - channels which are decoded (see TextureImage::decode)
+    void load(
+        const std::string &name,
+        std::vector<Reader> readers,
+        uint32_t channelCount,
+        bool mipLevels,
+        bool cubeMap,
+        Callback onLoaded);
+
+    // waits for decoding of all textures and creates them in order of requests,
+    // logs decode time of each layer and wall time of loading
+    void finish();
+
+private:
+    struct Decoded
+    {
+        TextureImage::Decoded file;
+
+        // reading and decoding time
+        float time;
+    };
+
+    struct Request
+    {
+        std::string name;
+        bool mipLevels;
+        bool cubeMap;
+        Callback onLoaded;
+        // in order of layers
+        std::vector<std::future<Decoded>> decodedLayers;
+    };
+
+    Device *device;
+
+    ThreadPool *threadPool;
+
+    std::vector<Request> requests;
+
+    Timer timer;
+};
+
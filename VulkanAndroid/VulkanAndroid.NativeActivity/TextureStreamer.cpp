@@ -0,0 +1,132 @@
+#include "TextureStreamer.h"
+#include "ActivityManager.h"
+#include <algorithm>
+
+TextureStreamer::TextureStreamer(Device *device) : device(device)
+{
+    threadPool = new ThreadPool(1);
+    tileThreadPool = new ThreadPool(2);
+
+    publishTimer.getDeltaSec();
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    releaseViews(UINT64_MAX);
+
+    delete tileThreadPool;
+    delete threadPool;
+}
+
+StreamingTexture* TextureStreamer::load(const std::string &path, bool cubeMap)
+{
+    if (!ActivityManager::hasAsset(path))
+    {
+        return nullptr;
+    }
+
+    // only header is read here, levels are read by worker
+    AssetView file = ActivityManager::openAsset(path);
+    if (!Ktx2File::isKtx2(file.getData(), file.getSize()))
+    {
+        return nullptr;
+    }
+
+    // levels which must be generated at runtime can't be streamed
+    if (Ktx2File(file.getData(), file.getSize()).getMipLevelCount() <= 1)
+    {
+        return nullptr;
+    }
+
+    auto texture = new StreamingTexture(device, threadPool, path, std::move(file), cubeMap);
+    textures.push_back(texture);
+
+    return texture;
+}
+
+VirtualTexture* TextureStreamer::loadVirtual(const std::string &path, uint32_t cacheTileCount)
+{
+    if (!ActivityManager::hasAsset(path))
+    {
+        return nullptr;
+    }
+
+    AssetView file = ActivityManager::openAsset(path);
+    if (!TiledTextureFile::isTiled(file.getData(), file.getSize()))
+    {
+        return nullptr;
+    }
+
+    if (!VirtualTexture::isSupported(device, TiledTextureFile(file.getData(), file.getSize())))
+    {
+        LOGI("Virtual texture isn't supported by device: %s", path.c_str());
+        return nullptr;
+    }
+
+    auto texture = new VirtualTexture(device, tileThreadPool, path, std::move(file), cacheTileCount);
+    virtualTextures.push_back(texture);
+
+    return texture;
+}
+
+bool TextureStreamer::update()
+{
+    bool publishRequired = false;
+    bool uploaded = true;
+    for (auto texture : textures)
+    {
+        publishRequired = texture->update() || publishRequired;
+        uploaded = uploaded && texture->isUploaded();
+    }
+
+    // the last levels are published without delay
+    return publishRequired && (uploaded || publishTimer.getElapsedSec() >= PUBLISH_INTERVAL);
+}
+
+bool TextureStreamer::updateTiles()
+{
+    bool uploaded = false;
+    for (auto texture : virtualTextures)
+    {
+        uploaded = texture->update() || uploaded;
+    }
+
+    return uploaded;
+}
+
+void TextureStreamer::publish(uint64_t frameNumber)
+{
+    for (auto texture : textures)
+    {
+        const VkImageView previousView = texture->publish();
+        if (previousView)
+        {
+            retiredViews.push_back({ previousView, frameNumber });
+        }
+    }
+
+    // fully resident textures aren't streamed anymore
+    textures.erase(
+        std::remove_if(textures.begin(), textures.end(), [](StreamingTexture *texture) { return texture->isResident(); }),
+        textures.end());
+
+    publishTimer.getDeltaSec();
+}
+
+void TextureStreamer::releaseViews(uint64_t completedFrameNumber)
+{
+    auto end = std::remove_if(
+        retiredViews.begin(),
+        retiredViews.end(),
+        [this, completedFrameNumber](const RetiredView &retiredView)
+        {
+            if (retiredView.frameNumber > completedFrameNumber)
+            {
+                return false;
+            }
+
+            vkDestroyImageView(device->get(), retiredView.view, nullptr);
+            return true;
+        });
+    retiredViews.erase(end, retiredViews.end());
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "StreamingTexture.h"
+#include "VirtualTexture.h"
+
+// streams higher mip levels of textures after scene is shown (see StreamingTexture),
+// publishing of uploaded levels requires rebinding of textures, so it's batched,
+// previous views are kept until frames which can sample them are completed;
+// also streams tiles of virtual textures (see VirtualTexture) which don't require publishing
+class TextureStreamer
+{
+public:
+    TextureStreamer(Device *device);
+
+    ~TextureStreamer();
+
+    // returns nullptr when asset isn't KTX 2.0 file with pre-generated mip levels,
+    // texture is owned by caller and must outlive streamer
+    StreamingTexture* load(const std::string &path, bool cubeMap);
+
+    // returns nullptr when asset isn't tiled texture or device doesn't support sparse residency,
+    // texture is owned by caller and must outlive streamer
+    VirtualTexture* loadVirtual(const std::string &path, uint32_t cacheTileCount);
+
+    // continues streaming of all textures (called every frame),
+    // returns true when uploaded levels must be published
+    bool update();
+
+    // binds and uploads read tiles of virtual textures (called every frame),
+    // returns true when new tiles become visible
+    bool updateTiles();
+
+    // descriptors of textures must be updated after that (before their next use),
+    // previous views are used by frames which are submitted until frameNumber (inclusive)
+    void publish(uint64_t frameNumber);
+
+    // destroys previous views which aren't used by frames anymore
+    void releaseViews(uint64_t completedFrameNumber);
+
+private:
+    struct RetiredView
+    {
+        VkImageView view;
+
+        // the last frame which can sample view
+        uint64_t frameNumber;
+    };
+
+    // minimal interval between publishing until all levels are uploaded
+    const float PUBLISH_INTERVAL = 0.25f;
+
+    Device *device;
+
+    // levels are read one by one, so memory for reading is limited
+    ThreadPool *threadPool;
+
+    // tiles are small, so several of them are read in parallel with levels
+    ThreadPool *tileThreadPool;
+
+    std::vector<StreamingTexture*> textures;
+
+    std::vector<VirtualTexture*> virtualTextures;
+
+    std::vector<RetiredView> retiredViews;
+
+    Timer publishTimer;
+};
@@ -0,0 +1,57 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+
+    for (uint32_t i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    condition.notify_all();
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+uint32_t ThreadPool::getThreadCount() const
+{
+    return uint32_t(threads.size());
+}
+
+void ThreadPool::work()
+{
+    while (true)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return stopped || !tasks.empty(); });
+
+            // remaining tasks are executed before exit
+            if (tasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        task();
+    }
+}
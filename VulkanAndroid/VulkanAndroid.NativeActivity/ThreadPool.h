@@ -0,0 +1,54 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <queue>
+#include <algorithm>
+
+// fixed set of worker threads which execute tasks in order of submission
+class ThreadPool
+{
+public:
+    // threadCount - 0 means number of cores
+    ThreadPool(uint32_t threadCount = 0);
+
+    // waits for completion of all submitted tasks
+    ~ThreadPool();
+
+    uint32_t getThreadCount() const;
+
+    template<class F>
+    auto submit(F task) -> std::future<decltype(task())>;
+
+private:
+    std::vector<std::thread> threads;
+
+    std::queue<std::function<void()>> tasks;
+
+    std::mutex mutex;
+
+    std::condition_variable condition;
+
+    bool stopped = false;
+
+    void work();
+};
+
+template<class F>
+auto ThreadPool::submit(F task) -> std::future<decltype(task())>
+{
+    // packaged task isn't copyable, but std::function requires copyable target
+    const auto packagedTask = std::make_shared<std::packaged_task<decltype(task())()>>(std::move(task));
+    auto future = packagedTask->get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push([packagedTask]() { (*packagedTask)(); });
+    }
+    condition.notify_one();
+
+    return future;
+}
+
@@ -0,0 +1,114 @@
+#include "TiledTextureFile.h"
+#include <algorithm>
+
+namespace
+{
+    // offsets of header fields (the same as TiledTextureWriter of asset cooker)
+    const size_t FORMAT_OFFSET = 8;
+    const size_t WIDTH_OFFSET = 12;
+    const size_t HEIGHT_OFFSET = 16;
+    const size_t LEVEL_COUNT_OFFSET = 20;
+    const size_t TILE_WIDTH_OFFSET = 24;
+    const size_t TILE_HEIGHT_OFFSET = 28;
+    const size_t TILE_SIZE_OFFSET = 32;
+    const size_t LEVEL_INDEX_OFFSET = 40;
+
+    // offset, tile count in row and tile count in column
+    const size_t LEVEL_INDEX_ENTRY_SIZE = sizeof(uint64_t) + 2 * sizeof(uint32_t);
+}
+
+// "VTEX", version 1
+const std::array<uint8_t, 8> TiledTextureFile::IDENTIFIER{
+    0x56, 0x54, 0x45, 0x58, 0x01, 0x00, 0x00, 0x00
+};
+
+TiledTextureFile::TiledTextureFile(const uint8_t *data, size_t size)
+{
+    LOGA(isTiled(data, size));
+
+    format = VkFormat(read<uint32_t>(data, size, FORMAT_OFFSET));
+    extent = VkExtent3D{
+        read<uint32_t>(data, size, WIDTH_OFFSET),
+        read<uint32_t>(data, size, HEIGHT_OFFSET),
+        1
+    };
+    mipLevelCount = read<uint32_t>(data, size, LEVEL_COUNT_OFFSET);
+    tileExtent = VkExtent2D{
+        read<uint32_t>(data, size, TILE_WIDTH_OFFSET),
+        read<uint32_t>(data, size, TILE_HEIGHT_OFFSET)
+    };
+    tileSize = read<uint32_t>(data, size, TILE_SIZE_OFFSET);
+
+    LOGA(format != VK_FORMAT_UNDEFINED);
+    LOGA(mipLevelCount > 0 && tileExtent.width > 0 && tileExtent.height > 0);
+
+    levels.resize(mipLevelCount);
+    for (uint32_t i = 0; i < mipLevelCount; i++)
+    {
+        const size_t entryOffset = LEVEL_INDEX_OFFSET + i * LEVEL_INDEX_ENTRY_SIZE;
+        levels[i] = Level{
+            read<uint64_t>(data, size, entryOffset),
+            read<uint32_t>(data, size, entryOffset + sizeof(uint64_t)),
+            read<uint32_t>(data, size, entryOffset + sizeof(uint64_t) + sizeof(uint32_t))
+        };
+
+        LOGA(levels[i].offset + levels[i].tileCountX * levels[i].tileCountY * tileSize <= size);
+    }
+}
+
+bool TiledTextureFile::isTiled(const uint8_t *data, size_t size)
+{
+    return size >= LEVEL_INDEX_OFFSET
+        && std::equal(IDENTIFIER.begin(), IDENTIFIER.end(), data);
+}
+
+VkFormat TiledTextureFile::getFormat() const
+{
+    return format;
+}
+
+VkExtent3D TiledTextureFile::getExtent() const
+{
+    return extent;
+}
+
+uint32_t TiledTextureFile::getMipLevelCount() const
+{
+    return mipLevelCount;
+}
+
+VkExtent2D TiledTextureFile::getTileExtent() const
+{
+    return tileExtent;
+}
+
+VkDeviceSize TiledTextureFile::getTileSize() const
+{
+    return tileSize;
+}
+
+TiledTextureFile::Level TiledTextureFile::getLevel(uint32_t index) const
+{
+    return levels[index];
+}
+
+VkDeviceSize TiledTextureFile::getTileOffset(uint32_t level, uint32_t x, uint32_t y) const
+{
+    const Level &levelInfo = levels[level];
+
+    LOGA(x < levelInfo.tileCountX && y < levelInfo.tileCountY);
+
+    return levelInfo.offset + (VkDeviceSize(y) * levelInfo.tileCountX + x) * tileSize;
+}
+
+template<class T>
+T TiledTextureFile::read(const uint8_t *data, size_t size, size_t offset)
+{
+    LOGA(offset + sizeof(T) <= size);
+
+    // fields are little endian as all supported devices
+    T value;
+    memcpy(&value, data + offset, sizeof(T));
+
+    return value;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <array>
+
+// header of tiled texture (.vtex) used by virtual texturing:
+// every mip level is divided into tiles of equal extent which are stored row by row,
+// edge tiles are padded to full extent, so each tile is one contiguous range of file;
+// only level index is parsed, tiles are read from file (see AssetView) separately
+class TiledTextureFile
+{
+public:
+    struct Level
+    {
+        // offset of the first tile from the beginning of file
+        VkDeviceSize offset;
+        uint32_t tileCountX;
+        uint32_t tileCountY;
+    };
+
+    // data - whole file, size is used for validation of level index
+    TiledTextureFile(const uint8_t *data, size_t size);
+
+    // checks identifier and version
+    static bool isTiled(const uint8_t *data, size_t size);
+
+    VkFormat getFormat() const;
+
+    VkExtent3D getExtent() const;
+
+    uint32_t getMipLevelCount() const;
+
+    // extent of tile in texels
+    VkExtent2D getTileExtent() const;
+
+    // size of tile data in bytes
+    VkDeviceSize getTileSize() const;
+
+    Level getLevel(uint32_t index) const;
+
+    VkDeviceSize getTileOffset(uint32_t level, uint32_t x, uint32_t y) const;
+
+private:
+    static const std::array<uint8_t, 8> IDENTIFIER;
+
+    VkFormat format;
+
+    VkExtent3D extent;
+
+    uint32_t mipLevelCount;
+
+    VkExtent2D tileExtent;
+
+    VkDeviceSize tileSize;
+
+    std::vector<Level> levels;
+
+    template<class T>
+    static T read(const uint8_t *data, size_t size, size_t offset);
+};
@@ -0,0 +1,41 @@
+#include "TimelineSemaphore.h"
+
+TimelineSemaphore::TimelineSemaphore(Device *device) : device(device)
+{
+    LOGA(device->timelineSemaphoresEnabled());
+
+    VkSemaphoreTypeCreateInfoKHR typeCreateInfo{
+        VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR,
+        nullptr,
+        VK_SEMAPHORE_TYPE_TIMELINE_KHR,
+        0
+    };
+
+    VkSemaphoreCreateInfo createInfo{
+        VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        &typeCreateInfo,
+        0,
+    };
+
+    CALL_VK(vkCreateSemaphore(device->get(), &createInfo, nullptr, &semaphore));
+}
+
+TimelineSemaphore::~TimelineSemaphore()
+{
+    vkDestroySemaphore(device->get(), semaphore, nullptr);
+}
+
+VkSemaphore TimelineSemaphore::get() const
+{
+    return semaphore;
+}
+
+uint64_t TimelineSemaphore::getValue() const
+{
+    return device->getSemaphoreValue(semaphore);
+}
+
+void TimelineSemaphore::wait(uint64_t value) const
+{
+    device->waitSemaphore(semaphore, value);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Device.h"
+
+// semaphore with monotonically increasing value (VK_KHR_timeline_semaphore),
+// one value can be awaited by several queues and by CPU
+class TimelineSemaphore
+{
+public:
+    TimelineSemaphore(Device *device);
+
+    ~TimelineSemaphore();
+
+    VkSemaphore get() const;
+
+    // last value signaled by GPU
+    uint64_t getValue() const;
+
+    // blocks until the value is signaled
+    void wait(uint64_t value) const;
+
+private:
+    Device *device;
+
+    VkSemaphore semaphore;
+};
+
@@ -15,3 +15,13 @@ float Timer::getDeltaSec()
 
 	return deltaSec;
 }
+
+float Timer::getElapsedSec() const
+{
+	if (lastTimePoint == time_point<steady_clock>::max())
+	{
+		return 0.0f;
+	}
+
+	return duration_cast<milliseconds>(steady_clock::now() - lastTimePoint).count() / 1000.0f;
+}
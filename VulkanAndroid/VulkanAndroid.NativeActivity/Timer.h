@@ -10,6 +10,9 @@ public:
 	// and save current time as last time point
 	float getDeltaSec();
 
+	// returns time passed since last time point in seconds without changing it
+	float getElapsedSec() const;
+
 private:
 	time_point<steady_clock> lastTimePoint = (time_point<steady_clock>::max)();
 };
@@ -0,0 +1,18 @@
+#include "TimerVsyncSource.h"
+
+TimerVsyncSource::TimerVsyncSource(nanoseconds period) : period(period), origin(steady_clock::now())
+{
+}
+
+time_point<steady_clock> TimerVsyncSource::getNextVsync(time_point<steady_clock> timePoint) const
+{
+    if (timePoint <= origin)
+    {
+        return origin;
+    }
+
+    // round up to the whole number of periods
+    const auto periodCount = (timePoint - origin + period - nanoseconds(1)) / period;
+
+    return origin + periodCount * period;
+}
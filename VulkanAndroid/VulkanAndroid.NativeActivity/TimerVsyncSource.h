@@ -0,0 +1,18 @@
+#pragma once
+#include "VsyncSource.h"
+
+// vsync time points with fixed period counted from creation,
+// used when display doesn't provide its own refresh events
+class TimerVsyncSource : public VsyncSource
+{
+public:
+    TimerVsyncSource(nanoseconds period);
+
+    time_point<steady_clock> getNextVsync(time_point<steady_clock> timePoint) const override;
+
+private:
+    nanoseconds period;
+
+    time_point<steady_clock> origin;
+};
+
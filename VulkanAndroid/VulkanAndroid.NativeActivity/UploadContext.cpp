@@ -0,0 +1,122 @@
+#include "UploadContext.h"
+#include "StagingRing.h"
+#include <algorithm>
+
+UploadContext::UploadContext(Device *device) : device(device)
+{
+    VkFenceCreateInfo createInfo{
+        VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+        nullptr,
+        0
+    };
+
+    CALL_VK(vkCreateFence(device->get(), &createInfo, nullptr, &fence));
+}
+
+UploadContext::~UploadContext()
+{
+    flush();
+
+    vkDestroyFence(device->get(), fence, nullptr);
+}
+
+VkCommandBuffer UploadContext::getCommandBuffer()
+{
+    batchedCount++;
+
+    if (commandBuffer)
+    {
+        return commandBuffer;
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{
+        VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        nullptr,
+        device->getCommandPool(),
+        VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        1,
+    };
+
+    CALL_VK(vkAllocateCommandBuffers(device->get(), &allocInfo, &commandBuffer));
+
+    VkCommandBufferBeginInfo beginInfo{
+        VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        nullptr,
+        VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        nullptr,
+    };
+
+    CALL_VK(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+
+    return commandBuffer;
+}
+
+void UploadContext::keep(StagingBuffer *stagingBuffer)
+{
+    stagingBuffers.push_back(stagingBuffer);
+
+    stagingSize += stagingBuffer->getSize();
+    peakStagingSize = (std::max)(peakStagingSize, stagingSize);
+
+    if (stagingSize >= STAGING_BUDGET)
+    {
+        flush();
+    }
+}
+
+void UploadContext::flush()
+{
+    if (!commandBuffer)
+    {
+        return;
+    }
+
+    CALL_VK(vkEndCommandBuffer(commandBuffer));
+
+    VkSubmitInfo submitInfo{
+        VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        nullptr,
+        0,
+        nullptr,
+        nullptr,
+        1,
+        &commandBuffer,
+        0,
+        nullptr,
+    };
+
+    CALL_VK(vkQueueSubmit(device->getGraphicsQueue(), 1, &submitInfo, fence));
+    device->getStagingRing()->submit(device->getGraphicsQueue());
+
+    CALL_VK(vkWaitForFences(device->get(), 1, &fence, true, UINT64_MAX));
+    CALL_VK(vkResetFences(device->get(), 1, &fence));
+
+    vkFreeCommandBuffers(device->get(), device->getCommandPool(), 1, &commandBuffer);
+    commandBuffer = VK_NULL_HANDLE;
+
+    for (auto stagingBuffer : stagingBuffers)
+    {
+        delete stagingBuffer;
+    }
+    stagingBuffers.clear();
+    stagingSize = 0;
+
+    device->getStagingRing()->update();
+
+    flushCount++;
+}
+
+uint32_t UploadContext::getBatchedCount() const
+{
+    return batchedCount;
+}
+
+uint32_t UploadContext::getFlushCount() const
+{
+    return flushCount;
+}
+
+VkDeviceSize UploadContext::getPeakStagingSize() const
+{
+    return peakStagingSize;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "StagingBuffer.h"
+
+// collects one time commands of loading phase (transfers, layout transitions, mipmap generation)
+// into one command buffer, which is submitted by flush with one fence when staging budget is reached or loading ends;
+// active context is set to device, so beginOneTimeCommands returns its command buffer
+class UploadContext
+{
+public:
+    UploadContext(Device *device);
+
+    ~UploadContext();
+
+    // begins recording if command buffer isn't recorded yet
+    VkCommandBuffer getCommandBuffer();
+
+    // staging buffer is destroyed after flush, commands which read it must be recorded already
+    void keep(StagingBuffer *stagingBuffer);
+
+    // submits all recorded commands and waits for completion
+    void flush();
+
+    // number of one time command sequences merged since creation
+    uint32_t getBatchedCount() const;
+
+    uint32_t getFlushCount() const;
+
+    // maximal size of staging buffers kept at once
+    VkDeviceSize getPeakStagingSize() const;
+
+private:
+    // kept staging buffers are flushed when their size reaches budget, so loading doesn't hold all of them
+    const VkDeviceSize STAGING_BUDGET = 16 * 1024 * 1024;
+
+    Device *device;
+
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+
+    VkFence fence;
+
+    std::vector<StagingBuffer*> stagingBuffers;
+
+    VkDeviceSize stagingSize = 0;
+
+    VkDeviceSize peakStagingSize = 0;
+
+    uint32_t batchedCount = 0;
+
+    uint32_t flushCount = 0;
+};
+
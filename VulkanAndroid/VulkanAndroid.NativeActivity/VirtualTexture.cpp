@@ -0,0 +1,799 @@
+#include "VirtualTexture.h"
+#include "StagingBuffer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const VkImageUsageFlags USAGE = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+}
+
+bool VirtualTexture::isSupported(Device *device, const TiledTextureFile &header)
+{
+    if (!device->sparseResidencyEnabled())
+    {
+        return false;
+    }
+
+    const VkExtent3D granularity = device->getSparseImageGranularity(header.getFormat(), USAGE);
+    const VkExtent2D tileExtent = header.getTileExtent();
+
+    return granularity.width == tileExtent.width && granularity.height == tileExtent.height;
+}
+
+VirtualTexture::VirtualTexture(
+    Device *device,
+    ThreadPool *threadPool,
+    const std::string &path,
+    AssetView file,
+    uint32_t cacheTileCount)
+    : threadPool(threadPool), path(path), file(std::move(file))
+{
+    const TiledTextureFile header(this->file.getData(), this->file.getSize());
+    tileExtent = header.getTileExtent();
+    tileSize = header.getTileSize();
+
+    LOGA(isSupported(device, header));
+
+    // tiles are copied by transfer queue if its granularity divides tile extent (edge tiles end at level edges)
+    const VkExtent3D transferGranularity = device->getTransferImageGranularity();
+    const bool transferQueue = transferGranularity.width > 0
+        && transferGranularity.height > 0
+        && tileExtent.width % transferGranularity.width == 0
+        && tileExtent.height % transferGranularity.height == 0;
+
+    const QueueFamilyIndices queueFamilyIndices = device->getQueueFamilyIndices();
+    std::vector<uint32_t> sharingFamilyIndices;
+    if (transferQueue && queueFamilyIndices.getTransfer() != queueFamilyIndices.getGraphics())
+    {
+        sharingFamilyIndices = { queueFamilyIndices.getGraphics(), queueFamilyIndices.getTransfer() };
+    }
+
+    createThisImage(
+        device,
+        VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT,
+        header.getFormat(),
+        header.getExtent(),
+        header.getMipLevelCount(),
+        1,
+        VK_SAMPLE_COUNT_1_BIT,
+        USAGE,
+        false,
+        sharingFamilyIndices);
+
+    // tiles are written while other tiles of the same level are sampled
+    sampledLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    levels.resize(mipLevels);
+    for (uint32_t i = 0; i < mipLevels; i++)
+    {
+        levels[i] = header.getLevel(i);
+    }
+
+    VkMemoryRequirements memoryRequirements;
+    vkGetImageMemoryRequirements(device->get(), image, &memoryRequirements);
+    pageSize = memoryRequirements.alignment;
+
+    uint32_t requirementCount = 0;
+    vkGetImageSparseMemoryRequirements(device->get(), image, &requirementCount, nullptr);
+    std::vector<VkSparseImageMemoryRequirements> sparseRequirements(requirementCount);
+    vkGetImageSparseMemoryRequirements(device->get(), image, &requirementCount, sparseRequirements.data());
+
+    const auto colorRequirements = std::find_if(
+        sparseRequirements.begin(),
+        sparseRequirements.end(),
+        [](const VkSparseImageMemoryRequirements &requirements)
+        {
+            return requirements.formatProperties.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT;
+        });
+    LOGA(colorRequirements != sparseRequirements.end());
+
+    tailLevel = (std::min)(colorRequirements->imageMipTailFirstLod, mipLevels);
+
+    pages.resize(tailLevel);
+    for (uint32_t i = 0; i < tailLevel; i++)
+    {
+        pages[i].assign(levels[i].tileCountX * levels[i].tileCountY, Page{ -1, false, 0 });
+    }
+
+    VkFenceCreateInfo fenceInfo{
+        VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+        nullptr,
+        0
+    };
+    CALL_VK(vkCreateFence(device->get(), &fenceInfo, nullptr, &fence));
+
+    VkSemaphoreCreateInfo semaphoreInfo{
+        VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        nullptr,
+        0
+    };
+    CALL_VK(vkCreateSemaphore(device->get(), &semaphoreInfo, nullptr, &bindSemaphore));
+    CALL_VK(vkCreateSemaphore(device->get(), &semaphoreInfo, nullptr, &framesSemaphore));
+
+    upload = new AsyncUpload(device, !transferQueue);
+
+    bindMipTail(*colorRequirements, memoryRequirements);
+    uploadMipTail();
+
+    pushFullView(VK_IMAGE_ASPECT_COLOR_BIT);
+
+    // texel of LOD map covers the same region as tile of level 0
+    const VkExtent3D lodMapExtent{ levels[0].tileCountX, levels[0].tileCountY, 1 };
+    lodMap = new TextureImage(
+        device,
+        0,
+        VK_FORMAT_R8_UNORM,
+        lodMapExtent,
+        1,
+        1,
+        VK_SAMPLE_COUNT_1_BIT,
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        false);
+    lodMap->pushFullView(VK_IMAGE_ASPECT_COLOR_BIT);
+    lodMap->pushSampler(VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+
+    lodLevels.resize((lodMapExtent.width * lodMapExtent.height + 3) / 4 * 4);
+    lodBuffer = new Buffer(device, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VkDeviceSize(lodLevels.size()));
+
+    // only mip tail is resident
+    updateLodLevels();
+    VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
+    recordLodMapUpdate(commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED);
+    device->endOneTimeCommands(commandBuffer);
+
+    // cache is allocated at once, so memory of texture doesn't depend on its resolution
+    const VkMemoryRequirements cacheRequirements{
+        pageSize * cacheTileCount,
+        pageSize,
+        memoryRequirements.memoryTypeBits
+    };
+    cacheMemory = device->getMemoryAllocator()->allocate(
+        cacheRequirements,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        0,
+        MemoryAllocator::STRATEGY_DEDICATED,
+        MemoryAllocator::CATEGORY_TEXTURE);
+
+    slotTiles.resize(cacheTileCount);
+    for (uint32_t i = cacheTileCount; i > 0; i--)
+    {
+        freeSlots.push_back(i - 1);
+    }
+
+    LOGI("Virtual texture created: %s, %dx%d, %d levels (%d in mip tail), cache of %d tiles (%.1f MB), uploads by %s queue.",
+        path.c_str(),
+        extent.width,
+        extent.height,
+        mipLevels,
+        mipLevels - tailLevel,
+        cacheTileCount,
+        float(cacheRequirements.size) / (1024.0f * 1024.0f),
+        transferQueue ? "transfer" : "graphics");
+}
+
+VirtualTexture::~VirtualTexture()
+{
+    // workers read pages of file
+    for (auto &read : reads)
+    {
+        read.read.wait();
+    }
+
+    delete upload;
+
+    if (evictionCommands)
+    {
+        vkFreeCommandBuffers(device->get(), device->getCommandPool(), 1, &evictionCommands);
+    }
+
+    delete lodBuffer;
+    delete lodMap;
+
+    vkDestroySemaphore(device->get(), framesSemaphore, nullptr);
+    vkDestroySemaphore(device->get(), bindSemaphore, nullptr);
+    vkDestroyFence(device->get(), fence, nullptr);
+
+    device->getMemoryAllocator()->free(cacheMemory);
+    device->getMemoryAllocator()->free(tailMemory);
+}
+
+void VirtualTexture::requestTiles(const FootprintEvaluator &getFootprint)
+{
+    feedbackNumber++;
+
+    if (tailLevel == 0)
+    {
+        return;
+    }
+
+    // the largest level which isn't in mip tail is traversed fully, finer levels only where required
+    const uint32_t level = tailLevel - 1;
+    for (uint32_t y = 0; y < levels[level].tileCountY; y++)
+    {
+        for (uint32_t x = 0; x < levels[level].tileCountX; x++)
+        {
+            requestTile(getFootprint, level, x, y);
+        }
+    }
+}
+
+bool VirtualTexture::update()
+{
+    bool uploaded = false;
+
+    if (upload->isPending())
+    {
+        if (!upload->update())
+        {
+            return false;
+        }
+
+        uploaded = true;
+    }
+
+    // upload waits for binding which waits for eviction commands
+    if (evictionCommands)
+    {
+        vkFreeCommandBuffers(device->get(), device->getCommandPool(), 1, &evictionCommands);
+        evictionCommands = VK_NULL_HANDLE;
+    }
+
+    std::vector<VkSparseImageMemoryBind> binds;
+    std::vector<Tile> tiles;
+    std::vector<int32_t> slots;
+
+    // reads are completed in order of requests, so coarser tiles are usually uploaded first
+    for (auto it = reads.begin(); it != reads.end() && tiles.size() < MAX_UPLOADED_TILES;)
+    {
+        if (it->read.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        // tile isn't required anymore, so it would be evicted first
+        Page &page = getPage(it->tile);
+        if (page.lastRequest + EVICTION_DELAY < feedbackNumber)
+        {
+            page.loading = false;
+            it = reads.erase(it);
+            continue;
+        }
+
+        const int32_t slot = acquireSlot(&binds);
+        if (slot < 0)
+        {
+            break;
+        }
+
+        // tile is resident (see LOD map) after its upload
+        page.loading = false;
+        slotTiles[slot] = it->tile;
+
+        it->read.get();
+
+        binds.push_back(createBind(it->tile, cacheMemory.memory, cacheMemory.offset + slot * pageSize));
+        tiles.push_back(it->tile);
+        slots.push_back(slot);
+
+        it = reads.erase(it);
+    }
+
+    if (tiles.empty())
+    {
+        return uploaded;
+    }
+
+    // evicted tiles could be sampled by frames which are submitted to graphics queue, so LOD map without them
+    // is written by graphics queue (frames which are submitted later don't sample them)
+    // and semaphore is signaled when previous frames are completed
+    const bool evicted = binds.size() > tiles.size();
+    if (evicted)
+    {
+        updateLodLevels();
+
+        const VkCommandBufferAllocateInfo allocInfo{
+            VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            nullptr,
+            device->getCommandPool(),
+            VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            1,
+        };
+        CALL_VK(vkAllocateCommandBuffers(device->get(), &allocInfo, &evictionCommands));
+
+        const VkCommandBufferBeginInfo beginInfo{
+            VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            nullptr,
+            VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+            nullptr,
+        };
+        CALL_VK(vkBeginCommandBuffer(evictionCommands, &beginInfo));
+        recordLodMapUpdate(evictionCommands, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        CALL_VK(vkEndCommandBuffer(evictionCommands));
+
+        const VkSubmitInfo framesInfo{
+            VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            nullptr,
+            0,
+            nullptr,
+            nullptr,
+            1,
+            &evictionCommands,
+            1,
+            &framesSemaphore
+        };
+        CALL_VK(vkQueueSubmit(device->getGraphicsQueue(), 1, &framesInfo, VK_NULL_HANDLE));
+    }
+
+    for (uint32_t i = 0; i < tiles.size(); i++)
+    {
+        getPage(tiles[i]).slot = slots[i];
+    }
+    updateLodLevels();
+
+    // evicted tiles are unbound and new ones are bound to their memory
+    const VkSparseImageMemoryBindInfo imageBind{
+        image,
+        uint32_t(binds.size()),
+        binds.data()
+    };
+    const VkBindSparseInfo bindInfo{
+        VK_STRUCTURE_TYPE_BIND_SPARSE_INFO,
+        nullptr,
+        evicted ? 1u : 0u,
+        &framesSemaphore,
+        0,
+        nullptr,
+        0,
+        nullptr,
+        1,
+        &imageBind,
+        1,
+        &bindSemaphore
+    };
+    CALL_VK(vkQueueBindSparse(device->getGraphicsQueue(), 1, &bindInfo, VK_NULL_HANDLE));
+
+    const VkCommandBuffer commandBuffer = upload->begin();
+
+    StagingBuffer *stagingBuffer = recordUpload(commandBuffer, tiles, VK_IMAGE_LAYOUT_GENERAL);
+
+    upload->finishImage(
+        this,
+        VK_IMAGE_LAYOUT_GENERAL,
+        VK_IMAGE_LAYOUT_GENERAL,
+        {
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,
+            mipLevels,
+            0,
+            1
+        });
+
+    // frames which are submitted after copying sample new tiles
+    recordLodMapUpdate(upload->getGraphicsCommands(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    // sparse binding isn't ordered with command buffers, so copying waits for it
+    upload->submit(stagingBuffer, bindSemaphore);
+
+    return uploaded;
+}
+
+DescriptorInfo VirtualTexture::getLodMapInfo() const
+{
+    return lodMap->getCombineSamplerInfo();
+}
+
+void VirtualTexture::bindMipTail(
+    const VkSparseImageMemoryRequirements &sparseRequirements,
+    const VkMemoryRequirements &memoryRequirements)
+{
+    if (tailLevel == mipLevels)
+    {
+        return;
+    }
+
+    const VkMemoryRequirements tailRequirements{
+        sparseRequirements.imageMipTailSize,
+        memoryRequirements.alignment,
+        memoryRequirements.memoryTypeBits
+    };
+    tailMemory = device->getMemoryAllocator()->allocate(
+        tailRequirements,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        0,
+        MemoryAllocator::STRATEGY_DEDICATED,
+        MemoryAllocator::CATEGORY_TEXTURE);
+
+    // image has one layer, so it has one mip tail
+    const VkSparseMemoryBind bind{
+        sparseRequirements.imageMipTailOffset,
+        sparseRequirements.imageMipTailSize,
+        tailMemory.memory,
+        tailMemory.offset,
+        0
+    };
+    const VkSparseImageOpaqueMemoryBindInfo opaqueBind{
+        image,
+        1,
+        &bind
+    };
+    const VkBindSparseInfo bindInfo{
+        VK_STRUCTURE_TYPE_BIND_SPARSE_INFO,
+        nullptr,
+        0,
+        nullptr,
+        0,
+        nullptr,
+        1,
+        &opaqueBind,
+        0,
+        nullptr,
+        0,
+        nullptr
+    };
+
+    // upload of mip tail can be batched with other one time commands, so binding is waited here
+    CALL_VK(vkQueueBindSparse(device->getGraphicsQueue(), 1, &bindInfo, fence));
+    CALL_VK(vkWaitForFences(device->get(), 1, &fence, true, UINT64_MAX));
+    CALL_VK(vkResetFences(device->get(), 1, &fence));
+}
+
+void VirtualTexture::uploadMipTail()
+{
+    std::vector<Tile> tiles;
+    for (uint32_t level = tailLevel; level < mipLevels; level++)
+    {
+        for (uint32_t y = 0; y < levels[level].tileCountY; y++)
+        {
+            for (uint32_t x = 0; x < levels[level].tileCountX; x++)
+            {
+                tiles.push_back(Tile{ level, x, y });
+            }
+        }
+    }
+
+    // non-resident tiles are transitioned too, so layout of image is the same everywhere
+    VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
+    StagingBuffer *tailStagingBuffer = recordUpload(commandBuffer, tiles, VK_IMAGE_LAYOUT_UNDEFINED);
+    memoryBarrier(
+        commandBuffer,
+        VK_IMAGE_LAYOUT_GENERAL,
+        VK_IMAGE_LAYOUT_GENERAL,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        {
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,
+            mipLevels,
+            0,
+            1
+        });
+    device->endOneTimeCommands(commandBuffer);
+
+    releaseStagingBuffer(tailStagingBuffer);
+}
+
+void VirtualTexture::requestTile(const FootprintEvaluator &getFootprint, uint32_t level, uint32_t x, uint32_t y)
+{
+    const VkExtent3D tileImageExtent = getTileImageExtent(Tile{ level, x, y });
+    const glm::vec2 levelExtent(
+        float((std::max)(extent.width >> level, 1u)),
+        float((std::max)(extent.height >> level, 1u)));
+    const glm::vec2 begin(float(x * tileExtent.width), float(y * tileExtent.height));
+    const glm::vec2 end = begin + glm::vec2(float(tileImageExtent.width), float(tileImageExtent.height));
+
+    const Optional<glm::vec2> footprint = getFootprint(begin / levelExtent, end / levelExtent);
+    if (!footprint.second)
+    {
+        return;
+    }
+
+    Page &page = pages[level][y * levels[level].tileCountX + x];
+    page.lastRequest = feedbackNumber;
+
+    if (page.slot < 0 && !page.loading && reads.size() < MAX_PENDING_READS)
+    {
+        const Tile tile{ level, x, y };
+        const size_t offset = size_t(getTileOffset(tile));
+        const size_t size = size_t(tileSize);
+
+        // tile is copied from file to staging buffer without waiting for storage
+        TileRead read{ tile, threadPool->submit([this, offset, size]()
+        {
+            file.prefetch(offset, size);
+        }) };
+        reads.push_back(std::move(read));
+
+        page.loading = true;
+    }
+
+    if (level == 0)
+    {
+        return;
+    }
+
+    // sampled level (texels of level 0 per pixel), finer level isn't required while this one is minified
+    const float texelsPerPixel = (std::max)(
+        footprint.first.x * float(extent.width),
+        footprint.first.y * float(extent.height));
+    if (std::log2(texelsPerPixel) - LOD_BIAS >= float(level))
+    {
+        return;
+    }
+
+    const TiledTextureFile::Level &finerLevel = levels[level - 1];
+    for (uint32_t finerY = 2 * y; finerY < (std::min)(2 * y + 2, finerLevel.tileCountY); finerY++)
+    {
+        for (uint32_t finerX = 2 * x; finerX < (std::min)(2 * x + 2, finerLevel.tileCountX); finerX++)
+        {
+            requestTile(getFootprint, level - 1, finerX, finerY);
+        }
+    }
+}
+
+int32_t VirtualTexture::acquireSlot(std::vector<VkSparseImageMemoryBind> *binds)
+{
+    if (!freeSlots.empty())
+    {
+        const uint32_t slot = freeSlots.back();
+        freeSlots.pop_back();
+
+        return int32_t(slot);
+    }
+
+    int32_t victim = -1;
+    uint64_t oldestRequest = feedbackNumber;
+    for (uint32_t i = 0; i < slotTiles.size(); i++)
+    {
+        const uint64_t lastRequest = getPage(slotTiles[i]).lastRequest;
+        if (lastRequest + EVICTION_DELAY < feedbackNumber && lastRequest < oldestRequest)
+        {
+            victim = int32_t(i);
+            oldestRequest = lastRequest;
+        }
+    }
+
+    if (victim >= 0)
+    {
+        getPage(slotTiles[victim]).slot = -1;
+        binds->push_back(createBind(slotTiles[victim], VK_NULL_HANDLE, 0));
+    }
+
+    return victim;
+}
+
+VkExtent3D VirtualTexture::getTileImageExtent(const Tile &tile) const
+{
+    const uint32_t levelWidth = (std::max)(extent.width >> tile.level, 1u);
+    const uint32_t levelHeight = (std::max)(extent.height >> tile.level, 1u);
+
+    return VkExtent3D{
+        (std::min)(tileExtent.width, levelWidth - tile.x * tileExtent.width),
+        (std::min)(tileExtent.height, levelHeight - tile.y * tileExtent.height),
+        1
+    };
+}
+
+VkDeviceSize VirtualTexture::getTileOffset(const Tile &tile) const
+{
+    const TiledTextureFile::Level &level = levels[tile.level];
+
+    return level.offset + (VkDeviceSize(tile.y) * level.tileCountX + tile.x) * tileSize;
+}
+
+VkSparseImageMemoryBind VirtualTexture::createBind(const Tile &tile, VkDeviceMemory memory, VkDeviceSize memoryOffset) const
+{
+    return VkSparseImageMemoryBind{
+        {
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            tile.level,
+            0
+        },
+        {
+            int32_t(tile.x * tileExtent.width),
+            int32_t(tile.y * tileExtent.height),
+            0
+        },
+        getTileImageExtent(tile),
+        memory,
+        memoryOffset,
+        0
+    };
+}
+
+VkBufferImageCopy VirtualTexture::createCopyRegion(const Tile &tile, VkDeviceSize bufferOffset) const
+{
+    return VkBufferImageCopy{
+        bufferOffset,
+        tileExtent.width,
+        tileExtent.height,
+        {
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            tile.level,
+            0,
+            1
+        },
+        {
+            int32_t(tile.x * tileExtent.width),
+            int32_t(tile.y * tileExtent.height),
+            0
+        },
+        getTileImageExtent(tile)
+    };
+}
+
+VirtualTexture::Page& VirtualTexture::getPage(const Tile &tile)
+{
+    return pages[tile.level][tile.y * levels[tile.level].tileCountX + tile.x];
+}
+
+void VirtualTexture::updateLodLevels()
+{
+    const uint32_t width = levels[0].tileCountX;
+    for (uint32_t y = 0; y < levels[0].tileCountY; y++)
+    {
+        for (uint32_t x = 0; x < width; x++)
+        {
+            // tile of coarser level covers tile of finer one (the last tiles of odd levels are clamped)
+            uint32_t level = tailLevel;
+            while (level > 0)
+            {
+                const Tile tile{
+                    level - 1,
+                    (std::min)(x >> (level - 1), levels[level - 1].tileCountX - 1),
+                    (std::min)(y >> (level - 1), levels[level - 1].tileCountY - 1)
+                };
+                if (getPage(tile).slot < 0)
+                {
+                    break;
+                }
+                level--;
+            }
+
+            lodLevels[y * width + x] = uint8_t(level);
+        }
+    }
+}
+
+void VirtualTexture::recordLodMapUpdate(VkCommandBuffer commandBuffer, VkImageLayout oldLayout)
+{
+    // buffer can be still read by previous copying
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0,
+        nullptr,
+        0,
+        nullptr,
+        0,
+        nullptr);
+
+    for (VkDeviceSize offset = 0; offset < lodLevels.size(); offset += MAX_BUFFER_UPDATE_SIZE)
+    {
+        vkCmdUpdateBuffer(
+            commandBuffer,
+            lodBuffer->get(),
+            offset,
+            (std::min)(MAX_BUFFER_UPDATE_SIZE, VkDeviceSize(lodLevels.size()) - offset),
+            lodLevels.data() + offset);
+    }
+
+    const VkMemoryBarrier bufferBarrier{
+        VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        nullptr,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_ACCESS_TRANSFER_READ_BIT
+    };
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        1,
+        &bufferBarrier,
+        0,
+        nullptr,
+        0,
+        nullptr);
+
+    const VkImageSubresourceRange subresourceRange{
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        0,
+        1,
+        0,
+        1
+    };
+
+    // frames which are submitted before don't read map after this barrier
+    lodMap->memoryBarrier(
+        commandBuffer,
+        oldLayout,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        0,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        subresourceRange);
+
+    const VkBufferImageCopy region{
+        0,
+        0,
+        0,
+        {
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,
+            0,
+            1
+        },
+        { 0, 0, 0 },
+        lodMap->getExtent()
+    };
+    vkCmdCopyBufferToImage(
+        commandBuffer,
+        lodBuffer->get(),
+        lodMap->get(),
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1,
+        &region);
+
+    lodMap->memoryBarrier(
+        commandBuffer,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        subresourceRange);
+}
+
+StagingBuffer* VirtualTexture::recordUpload(
+    VkCommandBuffer commandBuffer,
+    const std::vector<Tile> &tiles,
+    VkImageLayout oldLayout)
+{
+    auto uploadStagingBuffer = new StagingBuffer(device, tiles.size() * tileSize);
+
+    std::vector<VkBufferImageCopy> regions(tiles.size());
+    for (uint32_t i = 0; i < tiles.size(); i++)
+    {
+        uploadStagingBuffer->updateData(file.getData() + getTileOffset(tiles[i]), i * tileSize, tileSize);
+        regions[i] = createCopyRegion(tiles[i], i * tileSize);
+    }
+
+    // memory of evicted tiles isn't rebound until frames which could sample it are completed
+    // (see framesSemaphore), so only initial layout is transitioned
+    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED)
+    {
+        memoryBarrier(
+            commandBuffer,
+            oldLayout,
+            VK_IMAGE_LAYOUT_GENERAL,
+            0,
+            VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            {
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                0,
+                mipLevels,
+                0,
+                1
+            });
+    }
+
+    vkCmdCopyBufferToImage(
+        commandBuffer,
+        uploadStagingBuffer->get(),
+        image,
+        VK_IMAGE_LAYOUT_GENERAL,
+        uint32_t(regions.size()),
+        regions.data());
+
+    return uploadStagingBuffer;
+}
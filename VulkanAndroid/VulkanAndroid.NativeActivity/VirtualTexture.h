@@ -0,0 +1,179 @@
+#pragma once
+#include "TextureImage.h"
+#include "AsyncUpload.h"
+#include "Buffer.h"
+#include "TiledTextureFile.h"
+#include "ThreadPool.h"
+#include "utils.h"
+#include <list>
+
+// partially resident texture of tiled asset (see TiledTextureFile) with constant memory footprint:
+// residency of tiles is tracked by page table, resident tiles are bound to slots of fixed tile cache,
+// mip tail is always resident; pages of tiles required by the camera are read by worker thread,
+// tiles are bound (vkQueueBindSparse) and uploaded by transfer queue from thread which owns device queues,
+// least recently required tiles are evicted when cache is full;
+// shaders clamp sampled level of detail by LOD map of texture, so non-resident tiles aren't sampled
+class VirtualTexture : public TextureImage
+{
+public:
+    // returns area covered by one pixel in texture coordinates (u, v) for region of texture,
+    // the smallest one if it varies, second is false when region isn't visible
+    using FootprintEvaluator = std::function<Optional<glm::vec2>(glm::vec2 uvBegin, glm::vec2 uvEnd)>;
+
+    // device must support sparse residency (non-resident texels are zeros, see Device::sparseResidencyEnabled)
+    // and tile extent of file must be the same as sparse image granularity
+    static bool isSupported(Device *device, const TiledTextureFile &header);
+
+    // file - view of tiled asset which is kept until texture is destroyed,
+    // cacheTileCount - number of tiles which can be resident at the same time (except mip tail)
+    VirtualTexture(
+        Device *device,
+        ThreadPool *threadPool,
+        const std::string &path,
+        AssetView file,
+        uint32_t cacheTileCount);
+
+    ~VirtualTexture();
+
+    // feedback of frame: finds tiles which are sampled by the camera and requests missing ones,
+    // tiles of finer level are required only where coarser level is magnified
+    void requestTiles(const FootprintEvaluator &getFootprint);
+
+    // binds and uploads read tiles (must be called regularly by thread which owns device queues),
+    // returns true when new tiles become visible
+    bool update();
+
+    // LOD map for shaders (see lodMap): sampled level of detail of texture is max(LOD, map value * 255)
+    DescriptorInfo getLodMapInfo() const;
+
+private:
+    struct Page
+    {
+        // index of cache slot, -1 - tile isn't resident
+        int32_t slot;
+
+        bool loading;
+
+        // number of the last feedback which required tile
+        uint64_t lastRequest;
+    };
+
+    struct Tile
+    {
+        uint32_t level;
+        uint32_t x;
+        uint32_t y;
+    };
+
+    struct TileRead
+    {
+        Tile tile;
+        std::future<void> read;
+    };
+
+    // more reads are postponed to the next feedback, so the latest requests are prioritized
+    const uint32_t MAX_PENDING_READS = 32;
+
+    const uint32_t MAX_UPLOADED_TILES = 16;
+
+    // tile isn't evicted until all frames which could sample it are completed
+    const uint64_t EVICTION_DELAY = 4;
+
+    // finer level is required a bit before magnification, so sampled level is usually resident
+    const float LOD_BIAS = 0.5f;
+
+    // limit of data of one vkCmdUpdateBuffer
+    const VkDeviceSize MAX_BUFFER_UPDATE_SIZE = 65536;
+
+    ThreadPool *threadPool;
+
+    std::string path;
+
+    AssetView file;
+
+    VkExtent2D tileExtent;
+
+    VkDeviceSize tileSize;
+
+    std::vector<TiledTextureFile::Level> levels;
+
+    // tiles of this level and smaller levels are resident in mip tail
+    uint32_t tailLevel;
+
+    // page table - residency of each tile of levels before mip tail
+    std::vector<std::vector<Page>> pages;
+
+    // cache slot -> resident tile
+    std::vector<Tile> slotTiles;
+
+    std::vector<uint32_t> freeSlots;
+
+    // size of memory of one tile (sparse block)
+    VkDeviceSize pageSize;
+
+    MemoryAllocator::Allocation tailMemory{};
+
+    MemoryAllocator::Allocation cacheMemory{};
+
+    std::list<TileRead> reads;
+
+    uint64_t feedbackNumber = 0;
+
+    // binding of tiles is completed before their upload
+    VkSemaphore bindSemaphore;
+
+    // memory of evicted tiles is rebound after frames which have been submitted before
+    VkSemaphore framesSemaphore;
+
+    // tiles are written by transfer queue while other tiles of the same levels are sampled,
+    // so image is shared concurrently if transfer queue family isn't graphics one
+    AsyncUpload *upload;
+
+    // mip tail is bound at creation
+    VkFence fence;
+
+    // one texel (R8 - level / 255) per tile of level 0: the finest level which is resident in this region
+    // together with all coarser levels, it's written by graphics queue, so frames are ordered with its updates
+    TextureImage *lodMap;
+
+    // texels of LOD map, size is multiple of 4
+    std::vector<uint8_t> lodLevels;
+
+    // source of LOD map copying, it's written by commands, so it doesn't require staging
+    Buffer *lodBuffer;
+
+    // write LOD map without evicted tiles before their unbinding, completed before upload of new tiles
+    VkCommandBuffer evictionCommands = VK_NULL_HANDLE;
+
+    void bindMipTail(const VkSparseImageMemoryRequirements &sparseRequirements, const VkMemoryRequirements &memoryRequirements);
+
+    void uploadMipTail();
+
+    void requestTile(const FootprintEvaluator &getFootprint, uint32_t level, uint32_t x, uint32_t y);
+
+    // free slot or slot of least recently required tile (its unbinding is added to binds),
+    // -1 if all tiles of cache are required by recent frames
+    int32_t acquireSlot(std::vector<VkSparseImageMemoryBind> *binds);
+
+    VkExtent3D getTileImageExtent(const Tile &tile) const;
+
+    // offset of tile data in file
+    VkDeviceSize getTileOffset(const Tile &tile) const;
+
+    VkSparseImageMemoryBind createBind(const Tile &tile, VkDeviceMemory memory, VkDeviceSize memoryOffset) const;
+
+    // buffer contains tiles one after another, edge tiles are padded
+    VkBufferImageCopy createCopyRegion(const Tile &tile, VkDeviceSize bufferOffset) const;
+
+    Page& getPage(const Tile &tile);
+
+    // computes LOD map of resident tiles (see Page::slot)
+    void updateLodLevels();
+
+    // records writing of LOD map (it's sampled by fragment shaders or has undefined layout)
+    void recordLodMapUpdate(VkCommandBuffer commandBuffer, VkImageLayout oldLayout);
+
+    // records copying of tiles from file (and initial layout transition if old layout is undefined),
+    // returned staging buffer must live until commands are completed
+    StagingBuffer* recordUpload(VkCommandBuffer commandBuffer, const std::vector<Tile> &tiles, VkImageLayout oldLayout);
+};
@@ -0,0 +1,15 @@
+#pragma once
+#include <chrono>
+
+using namespace std::chrono;
+
+// source of display refresh time points
+class VsyncSource
+{
+public:
+    virtual ~VsyncSource() = default;
+
+    // returns the first vsync time point which is not earlier than timePoint
+    virtual time_point<steady_clock> getNextVsync(time_point<steady_clock> timePoint) const = 0;
+};
+
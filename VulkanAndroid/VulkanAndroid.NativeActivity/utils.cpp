@@ -71,3 +71,16 @@ std::string file::getFileName(std::string path)
 
     return path;
 }
+
+std::string file::replaceExtension(const std::string &path, const std::string &extension)
+{
+    const auto dotIndex = path.find_last_of('.');
+    const auto slashIndex = path.find_last_of("/\\");
+
+    if (dotIndex == std::string::npos || (slashIndex != std::string::npos && dotIndex < slashIndex))
+    {
+        return path + extension;
+    }
+
+    return path.substr(0, dotIndex) + extension;
+}
@@ -23,6 +23,9 @@ namespace axis
 namespace file
 {
     std::string getFileName(std::string path);
+
+    // replaces extension of file (with dot) or appends it if path has no extension
+    std::string replaceExtension(const std::string &path, const std::string &extension);
 }
 
 // Types:
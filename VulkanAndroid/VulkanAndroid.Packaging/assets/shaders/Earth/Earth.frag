@@ -14,6 +14,11 @@ layout(set = 1, binding = 0) uniform sampler2D dayTexture;
 layout(set = 1, binding = 1) uniform sampler2D nightTexture;
 layout(set = 1, binding = 2) uniform sampler2D normalTexture;
 
+// LOD maps of textures (see VirtualTexture)
+layout(set = 1, binding = 3) uniform sampler2D dayLodMap;
+layout(set = 1, binding = 4) uniform sampler2D nightLodMap;
+layout(set = 1, binding = 5) uniform sampler2D normalLodMap;
+
 layout(location = 0) in vec3 inPos;
 layout(location = 1) in vec2 inUV;
 layout(location = 2) in vec3 inNormal;
@@ -21,6 +26,13 @@ layout(location = 3) in vec3 inTangent;
 
 layout(location = 0) out vec4 outColor;
 
+// level of detail isn't finer than resident levels of region, so non-resident tiles aren't sampled
+vec4 sampleResident(sampler2D tex, sampler2D lodMap, vec2 uv)
+{
+	float minLod = textureLod(lodMap, uv, 0.0f).r * 255.0f;
+	return textureLod(tex, uv, max(textureQueryLod(tex, uv).y, minLod));
+}
+
 vec3 getBumpedNormal(vec3 N, vec3 T, vec2 uv)
 {
 	N = normalize(N);
@@ -32,9 +44,9 @@ vec3 getBumpedNormal(vec3 N, vec3 T, vec2 uv)
 	// texture v vector in world space
 	vec3 B = cross(T, N);
 
-	// N from texture
-	vec3 bumMapNormal = texture(normalTexture, uv).xyz;
-	bumMapNormal = 2.0f * bumMapNormal - vec3(1.0f, 1.0f, 1.0f);
+	// N from texture, z is reconstructed from x and y (normal map has two channels)
+	vec2 bumMapXY = 2.0f * sampleResident(normalTexture, normalLodMap, uv).xy - vec2(1.0f, 1.0f);
+	vec3 bumMapNormal = vec3(bumMapXY, sqrt(max(1.0f - dot(bumMapXY, bumMapXY), 0.0f)));
 
 	// N from texture in world space
 	vec3 resultNormal;
@@ -54,8 +66,8 @@ void main()
 
 	float diffuseFactor = max(dot(N, L), 0.0f);
 
-	vec3 result = (directedIntensity * diffuseFactor + ambientIntensity) * texture(dayTexture, inUV).rgb;
-	result += pow(1.0f - diffuseFactor, transitionFactor) * texture(nightTexture, inUV).rgb;
+	vec3 result = (directedIntensity * diffuseFactor + ambientIntensity) * sampleResident(dayTexture, dayLodMap, inUV).rgb;
+	result += pow(1.0f - diffuseFactor, transitionFactor) * sampleResident(nightTexture, nightLodMap, inUV).rgb;
 
     outColor = vec4(result, 1.0f);
 }
\ No newline at end of file